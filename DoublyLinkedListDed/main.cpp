@@ -1,6 +1,27 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#include "typedList.h"
 
 #define ANSI_COLOR_RED "\x1b[31m"
 #define ANSI_COLOR_GREEN "\x1b[32m"
@@ -17,754 +38,8177 @@
     }\
 }
 
-enum listValidity {
-    OK = 0,
-    LIST_NOT_FOUND = 1,
-    CORRUPTED = 2
+/**
+ * Slots are stored in chunks of LIST_CHUNK_SIZE elements. Chunks are never moved,
+ * so physical numbers of elements stay valid while the list grows
+ */
+
+const size_t LIST_CHUNK_SHIFT = 12;
+
+const size_t LIST_CHUNK_SIZE = (size_t) 1 << LIST_CHUNK_SHIFT;
+
+const size_t LIST_CHUNK_MASK = LIST_CHUNK_SIZE - 1;
+
+const size_t LIST_UNBOUNDED = (size_t) -1;
+
+/**
+ * Key scans resolve the order of at most this many matches without walking the whole list,
+ * more matches are found faster by following links from the end
+ */
+
+const size_t KEY_ORDER_CANDIDATES = 64;
+
+/**
+ * Optional index of every stride-th logical position. Anchors keep their physical numbers
+ * while the list changes, only their logical positions are patched
+ */
+
+struct jumpIndex_t {
+    size_t stride;
+    bool autoStride;
+    long long *anchors;
+    size_t *positions;
+    size_t count;
+    size_t allocated;
+    unsigned long long *anchorBits;
+    size_t bitCells;
+    bool valid;
+    size_t hits;
+    size_t rebuilds;
+};
+
+/**
+ * Lock-free stack of the empty cells used instead of emptyHead while concurrent slots are enabled.
+ * Top holds physical number plus one in the low SLOT_INDEX_BITS bits and a tag, which is
+ * incremented by every successful exchange, in the high bits, so that a cell which was popped
+ * and pushed back between the read and the exchange of a thread cannot be mistaken for an
+ * unchanged top (ABA problem)
+ */
+
+const unsigned SLOT_INDEX_BITS = 40;
+
+const unsigned long long SLOT_INDEX_MASK = (1ull << SLOT_INDEX_BITS) - 1;
+
+const size_t SLOT_MAGAZINE_SIZE = 64;
+
+struct slotAllocator_t {
+    std::atomic<unsigned long long> top;
+    std::atomic<long long> *link;
+    size_t capacity;
+};
+
+/**
+ * Per-thread cache of empty cells. Claims and releases go to the magazine, the shared stack
+ * is touched only to refill or flush half of it by a single exchange
+ */
+
+struct slotMagazine_t {
+    long long slots[SLOT_MAGAZINE_SIZE];
+    size_t count;
+};
+
+/**
+ * Multi-producer single-consumer queue over the cells of a list. Tail is written by producers
+ * and head only by the consumer, so they are kept on separate cache lines. Links are atomic
+ * and separate from next, since producers link cells while the consumer reads them
+ */
+
+struct mpscQueue_t {
+    std::atomic<long long> tail;
+    char tailPadding[64 - sizeof(std::atomic<long long>)];
+    long long head;
+    char headPadding[64 - sizeof(long long)];
+    std::atomic<long long> *next;
+};
+
+/**
+ * Single-producer single-consumer ring over cells [0, capacity). Head and tail are counters of
+ * taken and pushed values, the cell is the counter modulo capacity. Each side keeps a cached copy
+ * of the other counter on its own cache line and reloads it only when the ring looks full or empty
+ */
+
+struct spscRing_t {
+    std::atomic<size_t> tail;
+    size_t cachedHead;
+    char producerPadding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    std::atomic<size_t> head;
+    size_t cachedTail;
+    char consumerPadding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    size_t capacity;
+};
+
+#ifdef LIST_AOS_CELLS
+/**
+ * Cell of a chunk when the list is built with LIST_AOS_CELLS: value and both links lie
+ * in one record, so a step of traversal touches one cache line instead of three
+ */
+
+struct listCell_t {
+    void *value;
+    long long next;
+    long long prev;
 };
+#endif
+
+/**
+ * Cells (value, next, prev, chunk directory and the list of the empty cells) belong to
+ * the pool list. A list created by createList is its own pool, createSharedList makes
+ * a list that takes cells from the pool of another one.
+ * Values and links are kept in separate arrays of every chunk, or in one array of listCell_t
+ * records if LIST_AOS_CELLS is defined. Only listValue, listNext, listPrev and the chunk
+ * functions next to them know the layout.
+ * Links are always 64-bit, bounded lists too: listNext and listPrev return long long
+ * references which callers assign, and mapped files, snapshots and dumps store links as they
+ * are. Use typedList_t with listIndexFor<maxsize>::type for 16 or 32-bit links
+ */
 
 struct list_t {
-    void **value;
-    long long *next;
-    long long *prev;
+    list_t *pool;
+    size_t sharers;
+    size_t freeCells;
+#ifdef LIST_AOS_CELLS
+    listCell_t **cells;
+#else
+    void ***value;
+    long long **next;
+    long long **prev;
+#endif
+    long long **keys; // Optional inline keys, nullptr unless enableKeys was called
+    unsigned long long **keyed; // Bit per cell, set if the cell has a key
+    unsigned long long *keyMatches; // Bit per cell of directorySize chunks, scratch of key scans
+    unsigned long long **occupied; // Bit per cell, set if the cell belongs to some list
+    size_t chunks;
+    size_t directorySize;
     long long head;
     long long tail;
     size_t size;
+    size_t capacity;
     size_t maxsize;
     long long emptyHead;
+    size_t linearPrefix; // Logical positions below it are equal to physical numbers
+    jumpIndex_t *jump;
+    slotAllocator_t *slots; // Empty cells of the pool while concurrent slots are enabled
+    mpscQueue_t *queue; // Nodes of the list while queue mode is enabled
+    spscRing_t *ring; // Positions of the ring while ring mode is enabled
+    char *mapping; // Start of the file mapping if the list lives in a file, nullptr otherwise
+    size_t mappedSize;
     // stack_t free;
 };
 
-list_t *createList(size_t maxsize);
+/**
+ * File of a mapped list starts with this header, which contains the list itself, so head, tail,
+ * size, the list of the empty cells and other fields are changed right in the file.
+ * Pointer fields are restored by openListMapped. Cells follow from LIST_MAPPED_DATA_OFFSET
+ */
+
+const char LIST_MAPPED_MAGIC[8] = {'D', 'E', 'D', 'L', 'I', 'S', 'T', '1'};
+
+struct mappedHeader_t {
+    char magic[8];
+    size_t headerSize; // Size of the header of the build that wrote the file
+    size_t fileSize;
+    list_t list;
+};
+
+const size_t LIST_MAPPED_DATA_OFFSET = (sizeof(mappedHeader_t) + 4095) / 4096 * 4096;
+
+/**
+ * Snapshot of a list starts with LIST_SNAPSHOT_MAGIC, version and flags bytes, then maxsize
+ * (0 for unbounded) and size as varints, then values in logical order
+ */
+
+const unsigned char LIST_SNAPSHOT_MAGIC[4] = {'L', 'S', 'N', 'P'};
+
+const unsigned char LIST_SNAPSHOT_VERSION = 1;
+
+const unsigned char SNAPSHOT_HANDLES = 1; // Values are handles stored as zigzag varint deltas
+
+const size_t SNAPSHOT_BUFFER_SIZE = 1 << 16;
+
+struct snapshotWriter_t {
+    FILE *file;
+    unsigned char buffer[SNAPSHOT_BUFFER_SIZE];
+    size_t used;
+    bool failed;
+};
+
+struct snapshotReader_t {
+    FILE *file;
+    unsigned char buffer[SNAPSHOT_BUFFER_SIZE];
+    size_t used;
+    size_t filled;
+    unsigned char *scratch; // Values which cross the end of the buffer are gathered here
+    size_t scratchSize;
+};
+
+const size_t DUMP_BUFFER_SIZE = 1 << 20;
+
+/**
+ * Output buffer of dumps. Dump functions and nodeDump callbacks format text right into data,
+ * which is written to the file when it fills up. Without file the buffer grows instead
+ */
+
+struct dumpBuffer_t {
+    FILE *file;
+    char *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+};
+
+enum dumpFormat {
+    DUMP_DOT = 0,
+    DUMP_JSON_LINES = 1,
+    DUMP_BINARY = 2,
+    DUMP_SVG = 3
+};
+
+/**
+ * Options of listPhysicalDump which select format and limit it to a part of the pool. Cells are
+ * taken from the logical window if around is set, from the physical range otherwise, and are
+ * sampled evenly if there are more than maxCells of them. Binary format always holds the whole
+ * pool. dumpList uses only format, which is DUMP_DOT or DUMP_SVG for it, and clustered. Start from
+ * DUMP_ALL and change the needed fields
+ */
+
+struct dumpOptions_t {
+    long long firstCell; // Physical range [firstCell, lastCell) of the dumped cells
+    long long lastCell; // -1 for the end of the pool
+    long long around; // Node in the middle of the logical window, -1 for no window
+    size_t radius; // Number of nodes on each side of around
+    size_t maxCells; // Cap on the number of dumped cells, 0 for no cap
+    unsigned long long seed; // Seed of sampling
+    dumpFormat format;
+    unsigned threads; // Threads which format dot dump of all cells, 0 to use all cores
+    bool clustered; // Collapse runs of adjacent cells into one node in dot format
+};
+
+const dumpOptions_t DUMP_ALL = {0, -1, -1, 0, 0, 4417, DUMP_DOT, 1, false};
+
+/**
+ * Run of physically contiguous cells of clustered physical dump. Cells of an occupied run follow
+ * each other in the list, cells of an empty run follow each other in the list of the empty cells
+ */
+
+struct cellRun_t {
+    long long first;
+    long long last;
+    bool occupied;
+    bool descending; // Links go from last to first
+};
+
+/**
+ * Dot dump of all cells is a sequence of segments. Each segment is formatted on its own, so
+ * segments can be formatted on different threads and written in order
+ */
+
+enum dumpSection {
+    SECTION_TEXT = 0, // Fixed text
+    SECTION_CELLS = 1, // Cells of the first row of the table
+    SECTION_VALUES = 2, // Cells of the second row of the table, rendered by nodeDump
+    SECTION_NEXT_LINKS = 3, // Next links starting from the node until tail
+    SECTION_PREV_LINKS = 4, // Prev links starting from the node until head
+    SECTION_EMPTY_HEAD = 5, // The first empty cell
+    SECTION_EMPTY_LINKS = 6 // Links of the empty cells starting from the cell
+};
+
+struct dumpSegment_t {
+    dumpSection section;
+    const char *text;
+    long long first; // The first cell or node
+    size_t count; // Number of cells or links, links end at the end of their chain anyway
+};
+
+const size_t DUMP_SEGMENT_ITEMS = 1 << 15;
+
+/**
+ * Colors of head, tail, empty and other cells in dumps
+ */
+
+const char *const DUMP_DOT_COLORS[4] = {"cadetblue", "darkgoldenrod1", "indianred1", "seagreen1"};
+
+const char *const DUMP_SVG_COLORS[4] = {"#5f9ea0", "#ffb90f", "#ff6a6a", "#54ff9f"};
+
+/**
+ * SVG dumps are laid out in rows of SVG_ROW_CELLS cells or nodes without any graph layout
+ */
+
+const int SVG_ROW_CELLS = 32;
+
+const int SVG_CELL_WIDTH = 100;
+
+const int SVG_CELL_HEIGHT = 20;
+
+const int SVG_MARGIN = 40;
+
+const char LIST_DUMP_MAGIC[8] = {'D', 'E', 'D', 'D', 'U', 'M', 'P', '1'};
+
+/**
+ * Binary dump starts with this header. Values, next links and prev links of capacity cells
+ * follow as 8-byte numbers, then (capacity + 63) / 64 words of the occupancy bitmap
+ */
+
+struct dumpImageHeader_t {
+    char magic[8];
+    unsigned long long headerSize;
+    long long head;
+    long long tail;
+    unsigned long long size;
+    unsigned long long capacity;
+    unsigned long long maxsize; // 0 for unbounded
+    long long emptyHead;
+    unsigned long long chunkSize;
+};
+
+list_t *createList(size_t maxsize = LIST_UNBOUNDED);
+
+list_t *createSharedList(list_t *pool);
+
+size_t mappedFileSize(size_t maxsize);
+
+void mappedChunk(list_t *list, size_t chunk);
+
+int attachMappedChunks(list_t *list);
+
+list_t *createListMapped(const char *path, size_t maxsize);
+
+bool mappedHeaderValid(const list_t *list);
+
+list_t *openListMapped(const char *path);
+
+int syncListMapped(list_t *list);
+
+void *&listValue(list_t *list, long long node);
+
+long long &listNext(list_t *list, long long node);
+
+long long &listPrev(list_t *list, long long node);
+
+int growCellDirectories(list_t *list, size_t directorySize);
+
+int allocateCellChunk(list_t *list, size_t chunk, size_t cells);
+
+void copyCellChunk(list_t *copy, list_t *pool, size_t chunk, size_t cells);
+
+void storeCellValues(list_t *pool, long long first, void *const *values, size_t n);
+
+void freeCellChunk(list_t *list, size_t chunk);
+
+void freeCellDirectories(list_t *list);
+
+int growList(list_t *list);
+
+int allocateKeyChunk(list_t *pool, size_t chunk);
+
+size_t keyMatchWords(size_t directorySize);
+
+int enableKeys(list_t *list);
+
+void setNodeKey(list_t *list, long long node, long long key);
+
+bool hasNodeKey(list_t *list, long long node);
+
+long long getNodeKey(list_t *list, long long node);
+
+void clearNodeKey(list_t *list, long long node);
+
+unsigned long long matchKeys(const long long *keys, unsigned long long keyed, long long key);
+
+size_t scanKeys(list_t *pool, long long key, unsigned long long *matches);
+
+void markOccupied(list_t *list, long long node, bool occupied);
+
+bool isOccupied(list_t *list, long long node);
+
+void resetOccupancy(list_t *pool, size_t occupied);
+
+void forEachPhysical(list_t *list, void (*func)(void *, void *), void *arg);
+
+long long findAny(list_t *list, bool (*pred)(void *, void *), void *arg);
+
+size_t countIf(list_t *list, bool (*pred)(void *, void *), void *arg);
+
+int enableConcurrentSlots(list_t *list);
+
+void disableConcurrentSlots(list_t *list);
+
+long long claimSlot(list_t *list, slotMagazine_t *magazine = nullptr);
+
+void releaseSlot(list_t *list, long long node, slotMagazine_t *magazine = nullptr);
+
+void pushSlots(slotAllocator_t *slots, long long first, long long last);
+
+size_t popSlots(slotAllocator_t *slots, long long *cells, size_t count);
+
+void flushMagazine(list_t *list, slotMagazine_t *magazine);
+
+int enableQueueMode(list_t *list);
+
+void disableQueueMode(list_t *list);
+
+int enqueue(list_t *list, void *value, slotMagazine_t *magazine = nullptr);
+
+int dequeue(list_t *list, void **value, slotMagazine_t *magazine = nullptr);
+
+int enableRingMode(list_t *list);
+
+void disableRingMode(list_t *list);
+
+size_t ringSize(list_t *list);
+
+size_t ringPush(list_t *list, void *const *values, size_t n);
+
+size_t ringPop(list_t *list, void **values, size_t n);
+
+long long resolveKeyOrder(list_t *list, const unsigned long long *matches, size_t found, bool last);
+
+long long findFirstKey(list_t *list, long long key);
+
+long long findLastKey(list_t *list, long long key);
+
+void shrinkLinearPrefix(list_t *list, long long bound);
+
+void extendLinearPrefix(list_t *list, long long newNode);
+
+void enableJumpIndex(list_t *list, size_t stride = 0);
+
+void disableJumpIndex(list_t *list);
+
+void rebuildJumpIndex(list_t *list);
+
+bool isJumpAnchor(jumpIndex_t *jump, long long node);
+
+bool findJumpAnchor(list_t *list, long long node, long long *anchor);
+
+void patchJumpIndexInsert(list_t *list, long long newNode);
+
+void patchJumpIndexDelete(list_t *list, long long node);
+
+void invalidateJumpIndex(list_t *list);
+
+long long getElementByPosition(list_t *list, size_t position);
+
+long long getFirstElement(list_t *list);
+
+long long getLastElement(list_t *list);
+
+long long getNextElement(list_t *list, long long node);
+
+long long getPreviousElement(list_t *list, long long node);
+
+long long findFirstNode(list_t *list, void *value, bool (*cmp)(void *, void *));
+
+long long findLastNode(list_t *list, void *value, bool (*cmp)(void *, void *));
+
+long long getEmpty(list_t *list);
+
+void addEmpty(list_t *list, long long num);
+
+listValidity validateList(list_t *list);
+
+void deleteList(list_t **list);
+
+int addToHead(list_t *list, void *value);
+
+int addToTail(list_t *list, void *value);
+
+int insertAfter(list_t *list, long long elem, void *value);
+
+int insertBefore(list_t *list, long long elem, void *value);
+
+int insertRangeAfter(list_t *list, long long elem, void **values, size_t n);
+
+int appendRange(list_t *list, void **values, size_t n);
+
+void deleteNode(list_t *list, long long elem);
+
+size_t deleteNodes(list_t *list, const long long *nodes, size_t n);
+
+size_t removeIf(list_t *list, bool (*pred)(void *, void *), void *arg);
+
+void spliceEmpty(list_t *list, long long first, long long last, size_t count);
+
+int spliceRange(list_t *dst, long long after, list_t *src, long long first, long long last, size_t count);
+
+int concatLists(list_t *dst, list_t *src);
+
+list_t *splitList(list_t *list, long long node);
+
+void clearList(list_t *list);
+
+void sortList(list_t *list);
+
+void sortListBy(list_t *list, int (*cmp)(void *, void *));
+
+void sortListParallel(list_t *list, int (*cmp)(void *, void *), unsigned threads = 0);
+
+bool initDumpBuffer(dumpBuffer_t *buffer, FILE *file, size_t capacity = DUMP_BUFFER_SIZE);
+
+char *dumpReserve(dumpBuffer_t *buffer, size_t n);
+
+void dumpBytes(dumpBuffer_t *buffer, const char *data, size_t n);
+
+void dumpString(dumpBuffer_t *buffer, const char *str);
+
+void dumpInteger(dumpBuffer_t *buffer, long long number);
+
+void flushDump(dumpBuffer_t *buffer);
+
+void freeDumpBuffer(dumpBuffer_t *buffer);
+
+int dumpList(list_t *list, const char *dumpFilename, void (*nodeDump)(dumpBuffer_t *, list_t *, long long) = nullptr,
+             const dumpOptions_t *options = nullptr);
+
+void dumpChainDot(dumpBuffer_t *buffer, list_t *list, void (*nodeDump)(dumpBuffer_t *, list_t *, long long));
+
+void dumpChainClusters(dumpBuffer_t *buffer, list_t *list, void (*nodeDump)(dumpBuffer_t *, list_t *, long long));
+
+size_t collectCellRuns(list_t *list, cellRun_t **runs);
+
+size_t findCellRun(const cellRun_t *runs, size_t count, long long cell);
+
+void dumpCellClusters(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long));
+
+int listPhysicalDump(list_t *list, const char *dumpFilename, void (*nodeDump)(dumpBuffer_t *, list_t *, long long),
+                     const dumpOptions_t *options = nullptr);
+
+list_t *copyListCells(list_t *list);
+
+std::future<int> startAsyncDump(list_t *list, const char *dumpFilename,
+                                void (*nodeDump)(dumpBuffer_t *, list_t *, long long), const dumpOptions_t *options,
+                                bool physical);
+
+std::future<int> dumpListAsync(list_t *list, const char *dumpFilename,
+                               void (*nodeDump)(dumpBuffer_t *, list_t *, long long) = nullptr,
+                               const dumpOptions_t *options = nullptr);
+
+std::future<int> listPhysicalDumpAsync(list_t *list, const char *dumpFilename,
+                                       void (*nodeDump)(dumpBuffer_t *, list_t *, long long),
+                                       const dumpOptions_t *options = nullptr);
+
+int physicalCellKind(list_t *list, long long i);
+
+const char *physicalCellColor(list_t *list, long long i);
+
+size_t selectDumpCells(list_t *list, const dumpOptions_t *options, long long **cells);
+
+void dumpSelectedCells(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                       const long long *cells, size_t count);
+
+void collectChainSegments(list_t *list, dumpSection section, long long first, size_t items,
+                          std::vector<dumpSegment_t> *segments);
+
+void collectDumpSegments(list_t *list, size_t items, bool concurrent, std::vector<dumpSegment_t> *segments);
+
+void formatDumpSegment(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                       const dumpSegment_t *segment);
+
+void dumpAllCells(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long));
+
+void dumpAllCellsParallel(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                          unsigned threads);
+
+void dumpJsonLines(dumpBuffer_t *buffer, list_t *list, const dumpOptions_t *options);
+
+void dumpBinaryImage(dumpBuffer_t *buffer, list_t *list);
+
+void dumpEscaped(dumpBuffer_t *buffer, const char *data, size_t n);
+
+void dumpSvgText(dumpBuffer_t *buffer, dumpBuffer_t *scratch, list_t *list,
+                 void (*nodeDump)(dumpBuffer_t *, list_t *, long long), long long node);
+
+void dumpSvgStart(dumpBuffer_t *buffer, long long width, long long height);
+
+void dumpSvgCurve(dumpBuffer_t *buffer, long long fromX, long long fromY, long long toX, long long toY, long long bend,
+                  const char *style);
+
+void dumpSvgCells(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                  const long long *cells, size_t count);
+
+void dumpSvgChain(dumpBuffer_t *buffer, list_t *list, void (*nodeDump)(dumpBuffer_t *, list_t *, long long));
+
+void writeSnapshotBytes(snapshotWriter_t *writer, const void *data, size_t n);
+
+void writeVarint(snapshotWriter_t *writer, unsigned long long number);
+
+void flushSnapshot(snapshotWriter_t *writer);
+
+const unsigned char *readSnapshotBytes(snapshotReader_t *reader, size_t n);
+
+bool readVarint(snapshotReader_t *reader, unsigned long long *number);
+
+int saveList(list_t *list, const char *path, const void *(*serialize)(void *, size_t *, void *) = nullptr,
+             void *arg = nullptr);
+
+list_t *loadList(const char *path, void *(*deserialize)(const void *, size_t, void *) = nullptr, void *arg = nullptr);
+
+void nodeDump(dumpBuffer_t *buffer, list_t *list, long long node) { // Example function
+    dumpString(buffer, "{VALUE|");
+    dumpInteger(buffer, *(int *) listValue(list, node));
+    dumpString(buffer, "}|{NEXT|");
+    dumpInteger(buffer, listNext(list, node));
+    dumpString(buffer, "}|{PREVIOUS|");
+    dumpInteger(buffer, listPrev(list, node));
+    dumpString(buffer, "}");
+}
+
+void nodeDumpClear(dumpBuffer_t *buffer, list_t *list, long long node) { // Example function
+    if (listValue(list, node)) {
+        dumpString(buffer, "VALUE: ");
+        dumpInteger(buffer, *(int *) listValue(list, node));
+    } else {
+        dumpString(buffer, "EMPTY");
+    }
+}
+
+/**
+ * Function that tests typed list with the given cell layout
+ * @return Lib validity
+ */
+
+template<typename Layout>
+bool doTypedUnitTesting() {
+    bool valid = true;
+    typedList_t<int, Layout> *testList = createTypedList<int, Layout>(10);
+    UTEST(testList->head == -1, valid);
+    UTEST(testList->tail == -1, valid);
+
+    UTEST(addToHead(testList, 2) == 0, valid);
+    UTEST(addToTail(testList, 9) == 1, valid);
+    UTEST(insertAfter(testList, 1, 10) == 2, valid);
+    UTEST(insertBefore(testList, 0, 1) == 3, valid);
+    UTEST(testList->head == 3, valid);
+    UTEST(testList->tail == 2, valid);
+
+    for (int i = 2; i < 8; i++) {
+        insertAfter(testList, getElementByPosition(testList, i - 1), i + 1);
+        UTEST(listValue(testList, getElementByPosition(testList, i)) == i + 1, valid);
+    }
+
+    UTEST(testList->size == 10, valid);
+    UTEST(addToTail(testList, 11) == -1, valid);
+    UTEST(findFirstNode(testList, 5) == getElementByPosition(testList, 4), valid);
+    UTEST(findLastNode(testList, 42) == -1, valid);
+
+    deleteNode(testList, 3);
+    deleteNode(testList, 2);
+    UTEST(testList->size == 8, valid);
+    UTEST(validateList(testList) == OK, valid);
+
+    sortList(testList);
+    UTEST(validateList(testList) == OK, valid);
+    UTEST(testList->head == 0, valid);
+    UTEST(testList->tail == 7, valid);
+    UTEST(testList->emptyHead == 8, valid);
+
+    for (int i = 0; i < 8; i++) {
+        UTEST(listValue(testList, i) == i + 2, valid);
+    }
+
+    deleteList(&testList);
+    UTEST(!testList, valid);
+    return valid;
+}
+
+/**
+ * Function that checks that every position of the list is resolved correctly
+ * @param list Pointer to list_t
+ * @return True if all positions are correct
+ */
+
+bool checkAllPositions(list_t *list) {
+    long long node = list->head;
+
+    for (size_t i = 0; i < list->size; i++) {
+        if (getElementByPosition(list, i) != node)
+            return false;
+        node = listNext(list, node);
+    }
+
+    return node == -1;
+}
+
+/**
+ * Function that tests jump index on a fragmented list
+ * @return Lib validity
+ */
+
+bool doJumpIndexTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    list_t *testList = createList();
+
+    for (int i = 0; i < 200; i++) {
+        if (i % 2)
+            addToHead(testList, &vals[i % 10]);
+        else
+            addToTail(testList, &vals[i % 10]);
+    }
+
+    UTEST(testList->linearPrefix == 0, valid);
+    enableJumpIndex(testList, 8);
+    UTEST(checkAllPositions(testList), valid);
+    UTEST(testList->jump->rebuilds == 1, valid);
+    UTEST(testList->jump->hits > 0, valid);
+
+    insertAfter(testList, getElementByPosition(testList, 50), &vals[0]);
+    insertBefore(testList, getElementByPosition(testList, 120), &vals[1]);
+    addToHead(testList, &vals[2]);
+    addToTail(testList, &vals[3]);
+    deleteNode(testList, getElementByPosition(testList, 77));
+    deleteNode(testList, getElementByPosition(testList, 13));
+    UTEST(checkAllPositions(testList), valid);
+    UTEST(testList->jump->rebuilds == 1, valid);
+
+    for (int i = 0; i < 20; i++)
+        insertAfter(testList, getElementByPosition(testList, 100), &vals[4]);
+    UTEST(checkAllPositions(testList), valid);
+
+    deleteNode(testList, getElementByPosition(testList, 16));
+    UTEST(checkAllPositions(testList), valid);
+    UTEST(validateList(testList) == OK, valid);
+
+    disableJumpIndex(testList);
+    UTEST(checkAllPositions(testList), valid);
+    deleteList(&testList);
+    return valid;
+}
+
+/**
+ * Function that tests bulk insertion
+ * @return Lib validity
+ */
+
+bool doRangeTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    void *ptrs[10] = {};
+
+    for (int i = 0; i < 10; i++)
+        ptrs[i] = &vals[i];
+
+    list_t *testList = createList();
+    UTEST(growList(testList), valid);
+    storeCellValues(testList, 2, ptrs, 3);
+    UTEST(listValue(testList, 1) == nullptr && listValue(testList, 2) == &vals[0] &&
+          listValue(testList, 4) == &vals[2] && listValue(testList, 5) == nullptr, valid);
+    UTEST(listNext(testList, 3) == -1 && listPrev(testList, 3) == 4 && listPrev(testList, 4) == 5, valid);
+    for (long long cell = 2; cell < 5; cell++)
+        listValue(testList, cell) = nullptr;
+
+    UTEST(appendRange(testList, ptrs, 6), valid);
+    UTEST(testList->size == 6, valid);
+    UTEST(testList->head == 0, valid);
+    UTEST(testList->tail == 5, valid);
+    UTEST(testList->linearPrefix == 6, valid);
+
+    UTEST(insertRangeAfter(testList, 2, ptrs + 6, 4), valid);
+    UTEST(testList->size == 10, valid);
+    UTEST(testList->linearPrefix == 3, valid);
+    UTEST(getElementByPosition(testList, 3) == 6, valid);
+    UTEST(getElementByPosition(testList, 6) == 9, valid);
+    UTEST(getElementByPosition(testList, 7) == 3, valid);
+
+    UTEST(insertRangeAfter(testList, -1, ptrs, 2), valid);
+    UTEST(listValue(testList, testList->head) == &vals[0], valid);
+    UTEST(validateList(testList) == OK, valid);
+
+    int order[12] = {1, 2, 1, 2, 3, 7, 8, 9, 10, 4, 5, 6};
+    long long node = testList->head;
+
+    for (int i = 0; i < 12; i++) {
+        UTEST(*(int *) listValue(testList, node) == order[i], valid);
+        node = listNext(testList, node);
+    }
+
+    deleteNode(testList, 4);
+    UTEST(appendRange(testList, ptrs, 3), valid);
+    UTEST(validateList(testList) == OK, valid);
+    UTEST(testList->size == 14, valid);
+    deleteList(&testList);
+
+    list_t *boundedList = createList(4);
+    UTEST(!appendRange(boundedList, ptrs, 5), valid);
+    UTEST(appendRange(boundedList, ptrs, 4), valid);
+    deleteList(&boundedList);
+
+    return valid;
+}
+
+/**
+ * Example predicate for removeIf
+ * @param value Void pointer to int
+ * @param arg Void pointer to int divisor
+ * @return True if value is divisible by divisor
+ */
+
+bool isDivisible(void *value, void *arg) {
+    return *(int *) value % *(int *) arg == 0;
+}
+
+/**
+ * Function that tests batched deletion
+ * @return Lib validity
+ */
+
+bool doBatchDeletionTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    void *ptrs[10] = {};
+
+    for (int i = 0; i < 10; i++)
+        ptrs[i] = &vals[i];
+
+    list_t *testList = createList();
+    appendRange(testList, ptrs, 10);
+
+    long long nodes[6] = {3, 4, 5, 9, 0, 4};
+    UTEST(deleteNodes(testList, nodes, 6) == 5, valid);
+    UTEST(testList->size == 5, valid);
+    UTEST(testList->head == 1, valid);
+    UTEST(testList->tail == 8, valid);
+    UTEST(testList->linearPrefix == 0, valid);
+    UTEST(validateList(testList) == OK, valid);
+    UTEST(getElementByPosition(testList, 2) == 6, valid);
+
+    for (int i = 0; i < 5; i++)
+        UTEST(addToTail(testList, &vals[i]), valid);
+    UTEST(testList->capacity == LIST_CHUNK_SIZE, valid);
+    UTEST(validateList(testList) == OK, valid);
+
+    int divisor = 2;
+    UTEST(removeIf(testList, isDivisible, &divisor) == 4, valid);
+    UTEST(testList->size == 6, valid);
+    UTEST(validateList(testList) == OK, valid);
+
+    int order[6] = {3, 7, 9, 1, 3, 5};
+    long long node = testList->head;
+
+    for (int i = 0; i < 6; i++) {
+        UTEST(*(int *) listValue(testList, node) == order[i], valid);
+        UTEST(i == 0 || listPrev(testList, node) != -1, valid);
+        node = listNext(testList, node);
+    }
+
+    divisor = 1;
+    UTEST(removeIf(testList, isDivisible, &divisor) == 6, valid);
+    UTEST(testList->head == -1 && testList->tail == -1, valid);
+    UTEST(validateList(testList) == OK, valid);
+    deleteList(&testList);
+
+    return valid;
+}
+
+/**
+ * Function that checks that list contains the given ints in logical order
+ * @param list Pointer to list_t
+ * @param order Expected values
+ * @param n Number of values
+ * @return True if list matches
+ */
+
+bool checkOrder(list_t *list, const int *order, size_t n) {
+    if (list->size != n || validateList(list) != OK)
+        return false;
+
+    long long node = list->head;
+
+    for (size_t i = 0; i < n; i++) {
+        if (*(int *) listValue(list, node) != order[i])
+            return false;
+        if (listNext(list, node) != -1 && listPrev(list, listNext(list, node)) != node)
+            return false;
+        node = listNext(list, node);
+    }
+
+    return true;
+}
+
+/**
+ * Function that tests moving nodes between lists
+ * @return Lib validity
+ */
+
+bool doSpliceTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    void *ptrs[10] = {};
+
+    for (int i = 0; i < 10; i++)
+        ptrs[i] = &vals[i];
+
+    list_t *first = createList();
+    list_t *second = createSharedList(first);
+    appendRange(first, ptrs, 10);
+    appendRange(second, ptrs, 2);
+    UTEST(first->freeCells == LIST_CHUNK_SIZE - 12, valid);
+
+    UTEST(spliceRange(second, 10, first, 2, 4, 3), valid);
+    int firstOrder[7] = {1, 2, 6, 7, 8, 9, 10};
+    int secondOrder[5] = {1, 3, 4, 5, 2};
+    UTEST(checkOrder(first, firstOrder, 7), valid);
+    UTEST(checkOrder(second, secondOrder, 5), valid);
+    UTEST(first->linearPrefix == 2, valid);
+
+    UTEST(concatLists(first, second), valid);
+    UTEST(second->size == 0 && second->head == -1, valid);
+    int concatOrder[12] = {1, 2, 6, 7, 8, 9, 10, 1, 3, 4, 5, 2};
+    UTEST(checkOrder(first, concatOrder, 12), valid);
+
+    list_t *third = splitList(first, 8);
+    int splitOrder[7] = {9, 10, 1, 3, 4, 5, 2};
+    UTEST(checkOrder(first, concatOrder, 5), valid);
+    UTEST(checkOrder(third, splitOrder, 7), valid);
+
+    list_t *other = createList();
+    addToTail(other, &vals[9]);
+    UTEST(spliceRange(other, -1, third, getElementByPosition(third, 2), getElementByPosition(third, 5), 4), valid);
+    int otherOrder[5] = {1, 3, 4, 5, 10};
+    UTEST(checkOrder(other, otherOrder, 5), valid);
+    int restOrder[3] = {9, 10, 2};
+    UTEST(checkOrder(third, restOrder, 3), valid);
+    UTEST(first->freeCells == LIST_CHUNK_SIZE - 8, valid);
+
+    deleteList(&other);
+    deleteList(&third);
+    deleteList(&second);
+    UTEST(first->sharers == 0, valid);
+    deleteList(&first);
+
+    return valid;
+}
+
+/**
+ * Example comparator for sortListBy
+ * @param first Void pointer to int
+ * @param second Void pointer to int
+ * @return Difference of ints
+ */
+
+int compareInts(void *first, void *second) {
+    return *(int *) first - *(int *) second;
+}
+
+/**
+ * Function that tests sorting by values
+ * @return Lib validity
+ */
+
+bool doSortByTesting() {
+    bool valid = true;
+    int vals[12] = {5, 3, 9, 1, 3, 7, 5, 0, 2, 8, 3, 6};
+    list_t *testList = createList();
+
+    for (int i = 0; i < 12; i++) {
+        if (i % 2)
+            addToHead(testList, &vals[i]);
+        else
+            addToTail(testList, &vals[i]);
+    }
+
+    sortListBy(testList, compareInts);
+    UTEST(validateList(testList) == OK, valid);
+    UTEST(testList->size == 12, valid);
+
+    long long node = testList->head;
+    long long prev = -1;
+
+    while (node != -1) {
+        UTEST(listPrev(testList, node) == prev, valid);
+
+        if (prev != -1) {
+            int *a = (int *) listValue(testList, prev);
+            int *b = (int *) listValue(testList, node);
+            UTEST(*a <= *b, valid);
+        }
+
+        prev = node;
+        node = listNext(testList, node);
+    }
+
+    UTEST(testList->tail == prev, valid);
+    UTEST(*(int *) listValue(testList, testList->head) == 0, valid);
+    UTEST(getElementByPosition(testList, 11) == testList->tail, valid);
+    deleteList(&testList);
+
+    int keys[6] = {2, 1, 2, 1, 2, 1};
+    list_t *stableList = createList();
+
+    for (int i = 0; i < 6; i++)
+        addToTail(stableList, &keys[i]);
+
+    sortListBy(stableList, compareInts);
+    int *expected[6] = {&keys[1], &keys[3], &keys[5], &keys[0], &keys[2], &keys[4]};
+    node = stableList->head;
+
+    for (int i = 0; i < 6; i++) {
+        UTEST(listValue(stableList, node) == expected[i], valid);
+        node = listNext(stableList, node);
+    }
+
+    UTEST(stableList->linearPrefix == 0, valid);
+    sortListBy(stableList, compareInts);
+    UTEST(listValue(stableList, stableList->head) == &keys[1], valid);
+    deleteList(&stableList);
+
+    int many[1000] = {};
+    list_t *parallelList = createList();
+
+    for (int i = 0; i < 1000; i++) {
+        many[i] = (i * 7919) % 101;
+        if (i % 2)
+            addToHead(parallelList, &many[i]);
+        else
+            addToTail(parallelList, &many[i]);
+    }
+    deleteNode(parallelList, 500);
+    deleteNode(parallelList, 3);
+
+    void *sortedValues[998] = {};
+    long long source = parallelList->head;
+
+    for (int i = 0; i < 998; i++) {
+        sortedValues[i] = listValue(parallelList, source);
+        source = listNext(parallelList, source);
+    }
+
+    std::stable_sort(sortedValues, sortedValues + 998, [](void *a, void *b) { return compareInts(a, b) < 0; });
+
+    sortListParallel(parallelList, compareInts, 3);
+    UTEST(parallelList->size == 998, valid);
+    UTEST(parallelList->head == 0, valid);
+    UTEST(parallelList->tail == 997, valid);
+    UTEST(parallelList->emptyHead == 998, valid);
+    UTEST(parallelList->linearPrefix == 998, valid);
+    UTEST(validateList(parallelList) == OK, valid);
+
+    for (long long i = 0; i < 998; i++) {
+        UTEST(listValue(parallelList, i) == sortedValues[i], valid);
+        UTEST(listPrev(parallelList, i) == i - 1, valid);
+    }
+
+    UTEST(addToTail(parallelList, &many[0]), valid);
+    UTEST(parallelList->tail == 998, valid);
+    UTEST(parallelList->freeCells == LIST_CHUNK_SIZE - 999, valid);
+    deleteList(&parallelList);
+
+    return valid;
+}
+
+/**
+ * Function that tests inline keys and their scans
+ * @return Lib validity
+ */
+
+bool doKeyTesting() {
+    bool valid = true;
+    int data[200] = {};
+    list_t *testList = createList();
+
+    for (int i = 0; i < 200; i++) {
+        data[i] = (i * 37) % 50;
+        addToTail(testList, &data[i]);
+    }
+
+    UTEST(findFirstKey(testList, 3) == -1, valid);
+    UTEST(enableKeys(testList), valid);
+
+    for (long long i = 0; i < 200; i++)
+        setNodeKey(testList, i, i % 10);
+
+    UTEST(findFirstKey(testList, 3) == 3, valid);
+    UTEST(findLastKey(testList, 3) == 193, valid);
+    UTEST(findFirstKey(testList, 42) == -1, valid);
+    UTEST(findLastKey(testList, 42) == -1, valid);
+
+    addToHead(testList, &data[0]);
+    setNodeKey(testList, testList->head, 3);
+    UTEST(testList->head == 200, valid);
+    UTEST(findFirstKey(testList, 3) == 200, valid);
+    UTEST(findLastKey(testList, 3) == 193, valid);
+
+    deleteNode(testList, 193);
+    UTEST(findLastKey(testList, 3) == 183, valid);
+    deleteNode(testList, 200);
+    UTEST(findFirstKey(testList, 3) == 3, valid);
+    addToTail(testList, &data[0]);
+    UTEST(testList->tail == 200 && !hasNodeKey(testList, 200), valid);
+
+    for (long long node = testList->head; node != -1; node = listNext(testList, node))
+        setNodeKey(testList, node, *(int *) listValue(testList, node));
+
+    sortListParallel(testList, compareInts, 2);
+    UTEST(validateList(testList) == OK, valid);
+
+    for (long long node = testList->head; node != -1; node = listNext(testList, node))
+        UTEST(getNodeKey(testList, node) == *(int *) listValue(testList, node), valid);
+
+    UTEST(findFirstKey(testList, 0) == 0, valid);
+    UTEST(*(int *) listValue(testList, findLastKey(testList, 49)) == 49, valid);
+    UTEST(findLastKey(testList, 49) == testList->tail, valid);
+
+    for (size_t i = 0; i < 2 * LIST_CHUNK_SIZE; i++)
+        addToHead(testList, &data[1]);
+
+    setNodeKey(testList, LIST_CHUNK_SIZE + 7, 1000);
+    UTEST(findFirstKey(testList, 1000) == LIST_CHUNK_SIZE + 7, valid);
+    sortList(testList);
+    UTEST(getNodeKey(testList, testList->size - 1) == 49, valid);
+    UTEST(*(int *) listValue(testList, findFirstKey(testList, 25)) == 25, valid);
+
+    list_t *fragmented = createList();
+    enableKeys(fragmented);
+
+    for (int i = 0; i < 1000; i++) {
+        if (i % 2)
+            addToHead(fragmented, &data[i % 200]);
+        else
+            addToTail(fragmented, &data[i % 200]);
+
+        setNodeKey(fragmented, i, i % 3 ? i : i % 2 ? 5000 + i % 30 : 6000);
+    }
+
+    UTEST(findFirstKey(fragmented, 778) == 778 && findLastKey(fragmented, 778) == 778, valid);
+
+    const long long probes[] = {5003, 5015, 5027, 5004, 6000};
+    for (long long key : probes) {
+        long long first = -1;
+        long long last = -1;
+
+        for (long long node = fragmented->head; node != -1; node = listNext(fragmented, node)) {
+            if (getNodeKey(fragmented, node) == key) {
+                first = first == -1 ? node : first;
+                last = node;
+            }
+        }
+
+        UTEST(findFirstKey(fragmented, key) == first && findLastKey(fragmented, key) == last, valid);
+    }
+    deleteList(&fragmented);
+
+    list_t *other = createList();
+    addToTail(other, &data[0]);
+    UTEST(concatLists(other, testList), valid);
+    UTEST(testList->size == 0 && other->pool->keys, valid);
+    UTEST(!hasNodeKey(other, other->head), valid);
+    UTEST(getNodeKey(other, other->tail) == 49, valid);
+    UTEST(*(int *) listValue(other, findFirstKey(other, 25)) == 25, valid);
+    UTEST(findFirstKey(testList, 25) == -1, valid);
+
+    deleteList(&other);
+    deleteList(&testList);
+
+    return valid;
+}
+
+/**
+ * Function that checks that occupancy bitmap marks exactly the nodes of the list
+ * @param list Pointer to list_t which does not share its pool
+ * @return True if bitmap is consistent with links
+ */
+
+bool checkOccupancy(list_t *list) {
+    size_t occupied = 0;
+
+    for (long long node = 0; node < (long long) list->capacity; node++)
+        occupied += isOccupied(list, node);
+
+    for (long long node = list->head; node != -1; node = listNext(list, node)) {
+        if (!isOccupied(list, node))
+            return false;
+    }
+
+    return occupied == list->size;
+}
+
+/**
+ * Example function for forEachPhysical
+ * @param value Void pointer to int
+ * @param arg Void pointer to long long sum
+ */
+
+void addToSum(void *value, void *arg) {
+    *(long long *) arg += *(int *) value;
+}
+
+/**
+ * Function that tests scans in physical order
+ * @return Lib validity
+ */
+
+bool doPhysicalScanTesting() {
+    bool valid = true;
+    int data[300] = {};
+    list_t *testList = createList();
+
+    for (int i = 0; i < 300; i++) {
+        data[i] = i;
+        if (i % 3)
+            addToHead(testList, &data[i]);
+        else
+            addToTail(testList, &data[i]);
+    }
+
+    long long nodes[4] = {0, 17, 299, 150};
+    deleteNodes(testList, nodes, 4);
+    int divisor = 7;
+    removeIf(testList, isDivisible, &divisor);
+    void *range[3] = {&data[7], &data[14], &data[21]};
+    insertRangeAfter(testList, testList->head, range, 3);
+    UTEST(checkOccupancy(testList), valid);
+
+    long long sum = 0;
+    long long expectedSum = 0;
+    size_t expectedCount = 0;
+    divisor = 5;
+
+    for (long long node = testList->head; node != -1; node = listNext(testList, node)) {
+        expectedSum += *(int *) listValue(testList, node);
+        expectedCount += isDivisible(listValue(testList, node), &divisor);
+    }
+
+    forEachPhysical(testList, addToSum, &sum);
+    UTEST(sum == expectedSum, valid);
+    UTEST(countIf(testList, isDivisible, &divisor) == expectedCount, valid);
+
+    long long found = findAny(testList, isDivisible, &divisor);
+    UTEST(found != -1 && isDivisible(listValue(testList, found), &divisor), valid);
+    divisor = 1000;
+    UTEST(findAny(testList, isDivisible, &divisor) == -1, valid);
+
+    sortList(testList);
+    UTEST(checkOccupancy(testList), valid);
+    deleteNode(testList, 5);
+    UTEST(checkOccupancy(testList) && !isOccupied(testList, 5), valid);
+    sortListParallel(testList, compareInts, 2);
+    UTEST(checkOccupancy(testList), valid);
+
+    list_t *shared = createSharedList(testList);
+    long long first = getElementByPosition(testList, 10);
+    long long last = getElementByPosition(testList, 19);
+    UTEST(spliceRange(shared, -1, testList, first, last, 10), valid);
+    divisor = 1;
+    UTEST(countIf(testList, isDivisible, &divisor) == testList->size, valid);
+    UTEST(countIf(shared, isDivisible, &divisor) == 10, valid);
+    UTEST(findAny(shared, isDivisible, &divisor) == first, valid);
+    sum = 0;
+    forEachPhysical(shared, addToSum, &sum);
+    UTEST(sum == 11 + 12 + 13 + 14 + 15 + 16 + 18 + 19 + 20 + 21, valid);
+    deleteList(&shared);
+    deleteList(&testList);
+
+    return valid;
+}
+
+/**
+ * Function that tests concurrent slots
+ * @return Lib validity
+ */
+
+bool doConcurrentSlotsTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    list_t *testList = createList();
+
+    for (int i = 0; i < 100; i++)
+        addToTail(testList, &vals[i % 10]);
+    for (long long node = 0; node < 100; node += 10)
+        deleteNode(testList, node);
+
+    size_t freeCells = testList->freeCells;
+    UTEST(enableConcurrentSlots(testList), valid);
+    UTEST(testList->freeCells == 0 && testList->emptyHead == -1, valid);
+    UTEST(!growList(testList), valid);
+
+    const unsigned threads = 4;
+    std::vector<long long> claimed[threads];
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            slotMagazine_t magazine = {};
+
+            for (long long cell = claimSlot(testList, &magazine); cell != -1; cell = claimSlot(testList, &magazine))
+                claimed[t].push_back(cell);
+        });
+    }
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    std::vector<long long> all;
+    for (unsigned t = 0; t < threads; t++)
+        all.insert(all.end(), claimed[t].begin(), claimed[t].end());
+    std::sort(all.begin(), all.end());
+
+    UTEST(all.size() == freeCells, valid);
+    UTEST(std::unique(all.begin(), all.end()) == all.end(), valid);
+    UTEST(std::none_of(all.begin(), all.end(), [&](long long cell) { return isOccupied(testList, cell); }), valid);
+    UTEST(claimSlot(testList) == -1 && !addToTail(testList, &vals[0]), valid);
+
+    workers.clear();
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            slotMagazine_t magazine = {};
+
+            for (long long cell : claimed[t])
+                releaseSlot(testList, cell, &magazine);
+            flushMagazine(testList, &magazine);
+        });
+    }
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    UTEST(addToTail(testList, &vals[0]), valid);
+    UTEST(insertAfter(testList, testList->head, &vals[1]), valid);
+    UTEST(testList->size == 92, valid);
+    int divisor = 3;
+    size_t removed = removeIf(testList, isDivisible, &divisor);
+    UTEST(removed == 30, valid);
+    UTEST(validateList(testList) == OK && checkOccupancy(testList), valid);
+
+    disableConcurrentSlots(testList);
+    UTEST(!testList->slots, valid);
+    UTEST(testList->freeCells == testList->capacity - testList->size, valid);
+
+    size_t emptyCount = 0;
+    for (long long node = testList->emptyHead; node != -1; node = listPrev(testList, node))
+        emptyCount++;
+    UTEST(emptyCount == testList->freeCells, valid);
+
+    for (size_t i = 0; i < LIST_CHUNK_SIZE; i++)
+        UTEST(addToTail(testList, &vals[i % 10]), valid);
+    UTEST(testList->chunks == 2 && validateList(testList) == OK, valid);
+    deleteList(&testList);
+
+    return valid;
+}
+
+/**
+ * Function that tests queue mode
+ * @return Lib validity
+ */
+
+bool doQueueTesting() {
+    bool valid = true;
+    const unsigned producers = 4;
+    const int perProducer = 1000;
+    static int data[producers * perProducer] = {};
+    list_t *testList = createList();
+
+    for (int i = 0; i < (int) (producers * perProducer); i++)
+        data[i] = i;
+
+    for (int i = 0; i < 3; i++)
+        addToTail(testList, &data[i]);
+
+    UTEST(enableQueueMode(testList), valid);
+    UTEST(testList->size == 0 && testList->head == -1, valid);
+    UTEST(enqueue(testList, &data[3]), valid);
+
+    void *value = nullptr;
+    UTEST(dequeue(testList, &value) && value == &data[0], valid);
+    UTEST(dequeue(testList, &value) && value == &data[1], valid);
+
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < producers; t++) {
+        workers.emplace_back([&, t]() {
+            slotMagazine_t magazine = {};
+
+            for (int i = 0; i < perProducer; i++) {
+                while (!enqueue(testList, &data[t * perProducer + i], &magazine))
+                    std::this_thread::yield();
+            }
+
+            flushMagazine(testList, &magazine);
+        });
+    }
+
+    slotMagazine_t consumerMagazine = {};
+    int last[producers] = {-1, -1, -1, -1};
+    bool ordered = true;
+    size_t taken = 0;
+
+    UTEST(dequeue(testList, &value, &consumerMagazine) && value == &data[2], valid);
+    UTEST(dequeue(testList, &value, &consumerMagazine) && value == &data[3], valid);
+
+    while (taken < producers * perProducer) {
+        if (!dequeue(testList, &value, &consumerMagazine)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        int number = *(int *) value;
+        ordered = ordered && number > last[number / perProducer];
+        last[number / perProducer] = number;
+        taken++;
+    }
+
+    for (std::thread &worker : workers)
+        worker.join();
+    flushMagazine(testList, &consumerMagazine);
+
+    UTEST(ordered, valid);
+    UTEST(!dequeue(testList, &value), valid);
+
+    for (int i = 0; i < 3; i++)
+        enqueue(testList, &data[10 + i]);
+    UTEST(dequeue(testList, &value) && value == &data[10], valid);
+
+    disableQueueMode(testList);
+    UTEST(!testList->queue && !testList->slots, valid);
+    UTEST(testList->size == 2 && validateList(testList) == OK, valid);
+    UTEST(listValue(testList, testList->head) == &data[11], valid);
+    UTEST(listValue(testList, testList->tail) == &data[12], valid);
+    UTEST(checkOccupancy(testList), valid);
+    UTEST(testList->freeCells == testList->capacity - 2, valid);
+    UTEST(addToHead(testList, &data[0]), valid);
+
+    UTEST(enableQueueMode(testList), valid);
+    deleteList(&testList);
+
+    return valid;
+}
+
+/**
+ * Function that tests ring mode
+ * @return Lib validity
+ */
+
+bool doRingTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    void *ptrs[10] = {};
+
+    for (int i = 0; i < 10; i++)
+        ptrs[i] = &vals[i];
+
+    list_t *unbounded = createList();
+    UTEST(!enableRingMode(unbounded), valid);
+    deleteList(&unbounded);
+
+    list_t *testList = createList(8);
+    addToTail(testList, ptrs[1]);
+    addToHead(testList, ptrs[0]);
+    addToTail(testList, ptrs[2]);
+
+    UTEST(enableRingMode(testList), valid);
+    UTEST(ringSize(testList) == 3, valid);
+    UTEST(getFirstElement(testList) == 0 && getLastElement(testList) == 2, valid);
+    UTEST(listValue(testList, 0) == ptrs[0], valid);
+
+    UTEST(ringPush(testList, ptrs + 3, 7) == 5, valid);
+    UTEST(ringPush(testList, ptrs, 1) == 0, valid);
+
+    void *taken[10] = {};
+    UTEST(ringPop(testList, taken, 2) == 2, valid);
+    UTEST(taken[0] == ptrs[0] && taken[1] == ptrs[1], valid);
+    UTEST(ringPush(testList, ptrs + 8, 2) == 2, valid);
+    UTEST(getFirstElement(testList) == 2 && getLastElement(testList) == 1, valid);
+    UTEST(getPreviousElement(testList, 2) == -1, valid);
+
+    long long node = getFirstElement(testList);
+    for (int i = 2; i < 10; i++) {
+        UTEST(listValue(testList, node) == ptrs[i], valid);
+        node = getNextElement(testList, node);
+    }
+    UTEST(node == -1, valid);
+
+    UTEST(ringPop(testList, taken, 3) == 3 && taken[2] == ptrs[4], valid);
+
+    const size_t total = 100000;
+    bool ordered = true;
+    std::thread producer([&]() {
+        size_t pushed = 0;
+        void *batch[3] = {};
+
+        while (pushed < total) {
+            for (size_t i = 0; i < 3; i++)
+                batch[i] = (void *) (pushed + i + 1);
+            pushed += ringPush(testList, batch, std::min((size_t) 3, total - pushed));
+        }
+    });
+
+    UTEST(ringPop(testList, taken, 5) == 5 && taken[4] == ptrs[9], valid);
+
+    for (size_t popped = 0; popped < total;) {
+        size_t count = ringPop(testList, taken, 4);
+
+        for (size_t i = 0; i < count; i++)
+            ordered = ordered && taken[i] == (void *) (popped + i + 1);
+        popped += count;
+    }
+
+    producer.join();
+    UTEST(ordered, valid);
+    UTEST(ringSize(testList) == 0 && getFirstElement(testList) == -1, valid);
+
+    ringPush(testList, ptrs, 6);
+    ringPop(testList, taken, 4);
+    ringPush(testList, ptrs + 6, 4);
+    disableRingMode(testList);
+    UTEST(!testList->ring && testList->size == 6, valid);
+    UTEST(validateList(testList) == OK && checkOccupancy(testList), valid);
+    UTEST(testList->linearPrefix == 6 && testList->freeCells == 2, valid);
+
+    node = testList->head;
+    for (int i = 4; i < 10; i++) {
+        UTEST(listValue(testList, node) == ptrs[i], valid);
+        node = listNext(testList, node);
+    }
+
+    UTEST(addToTail(testList, ptrs[0]) && addToTail(testList, ptrs[1]), valid);
+    UTEST(!addToTail(testList, ptrs[2]), valid);
+    UTEST(enableRingMode(testList), valid);
+    deleteList(&testList);
+
+    return valid;
+}
+
+/**
+ * Function that tests lists stored in files
+ * @return Lib validity
+ */
+
+bool doMappedTesting() {
+    bool valid = true;
+    const char *path = "unitTestingMapped.list";
+    const size_t maxsize = 2 * LIST_CHUNK_SIZE + 100;
+    list_t *testList = createListMapped(path, maxsize);
+
+    UTEST(testList && testList->capacity == 0, valid);
+    if (!testList)
+        return false;
+
+    for (long long i = 0; i < 5000; i++) {
+        if (i % 3)
+            addToTail(testList, (void *) i);
+        else
+            addToHead(testList, (void *) i);
+    }
+
+    long long nodes[3] = {10, 4000, 4999};
+    deleteNodes(testList, nodes, 3);
+    UTEST(testList->chunks == 2, valid);
+
+    std::vector<void *> order;
+    for (long long node = testList->head; node != -1; node = listNext(testList, node))
+        order.push_back(listValue(testList, node));
+
+    UTEST(syncListMapped(testList), valid);
+    deleteList(&testList);
+    UTEST(!testList, valid);
+
+    testList = openListMapped(path);
+    UTEST(testList, valid);
+    if (!testList)
+        return false;
+
+    UTEST(testList->size == 4997 && testList->maxsize == maxsize, valid);
+    UTEST(validateList(testList) == OK && checkOccupancy(testList), valid);
+
+    size_t position = 0;
+    bool same = true;
+    for (long long node = testList->head; node != -1; node = listNext(testList, node))
+        same = same && listValue(testList, node) == order[position++];
+    UTEST(same && position == order.size(), valid);
+
+    while (addToTail(testList, (void *) 1))
+        ;
+    UTEST(testList->size == maxsize && testList->chunks == 3, valid);
+    deleteNode(testList, testList->head);
+    deleteList(&testList);
+
+    testList = openListMapped(path);
+    UTEST(testList && testList->size == maxsize - 1, valid);
+    UTEST(testList && validateList(testList) == OK, valid);
+
+    if (testList) {
+        size_t chunks = testList->chunks;
+        size_t capacity = testList->capacity;
+        long long tail = testList->tail;
+
+        testList->chunks = (maxsize + LIST_CHUNK_MASK) / LIST_CHUNK_SIZE + 1;
+        UTEST(!openListMapped(path), valid);
+        testList->chunks = 1;
+        UTEST(!openListMapped(path), valid);
+        testList->chunks = chunks;
+        testList->capacity = maxsize + 1;
+        UTEST(!openListMapped(path), valid);
+        testList->capacity = capacity;
+        testList->tail = (long long) capacity;
+        UTEST(!openListMapped(path), valid);
+        testList->tail = tail;
+
+        deleteList(&testList);
+    }
+
+    testList = openListMapped(path);
+    UTEST(testList, valid);
+    if (testList)
+        deleteList(&testList);
+
+    UTEST(!openListMapped("unitTestingDump.dot"), valid);
+    UTEST(!openListMapped("missing.list"), valid);
+    remove(path);
+
+    return valid;
+}
+
+/**
+ * Example serializer for saveList
+ * @param value Void pointer to int
+ * @param size Place for the number of bytes
+ * @param arg Unused
+ * @return Pointer to bytes of int
+ */
+
+const void *serializeInt(void *value, size_t *size, void *) {
+    *size = sizeof(int);
+    return value;
+}
+
+/**
+ * Example deserializer for loadList, ints are placed one after another into the given array
+ * @param bytes Bytes of int
+ * @param size Number of bytes
+ * @param arg Void pointer to pointer to the next free int
+ * @return Void pointer to int
+ */
+
+void *deserializeInt(const void *bytes, size_t size, void *arg) {
+    int *place = (*(int **) arg)++;
+    memcpy(place, bytes, size);
+    return place;
+}
+
+/**
+ * Function that tests binary snapshots
+ * @return Lib validity
+ */
+
+bool doSnapshotTesting() {
+    bool valid = true;
+    const char *path = "unitTestingSnapshot.bin";
+    const int n = 3 * LIST_CHUNK_SIZE + 5;
+    list_t *testList = createList();
+
+    for (long long i = 0; i < n; i++) {
+        if (i % 2)
+            addToHead(testList, (void *) (i * 1000003 % 7919));
+        else
+            addToTail(testList, (void *) (i << 40));
+    }
+    deleteNode(testList, 17);
+
+    UTEST(saveList(testList, path), valid);
+    UTEST(!loadList(path, deserializeInt, nullptr), valid);
+
+    list_t *loaded = loadList(path);
+    UTEST(loaded && loaded->size == testList->size && loaded->maxsize == LIST_UNBOUNDED, valid);
+    UTEST(loaded && loaded->head == 0 && loaded->linearPrefix == loaded->size, valid);
+    UTEST(loaded && validateList(loaded) == OK, valid);
+
+    bool same = loaded != nullptr;
+    for (long long node = testList->head, copy = 0; same && node != -1; node = listNext(testList, node), copy++)
+        same = listValue(loaded, copy) == listValue(testList, node);
+    UTEST(same, valid);
+
+    if (loaded)
+        deleteList(&loaded);
+    deleteList(&testList);
+
+    int vals[5] = {7, -3, 100000, 0, 42};
+    testList = createList(10);
+    for (int i = 0; i < 5; i++)
+        addToHead(testList, &vals[i]);
+
+    UTEST(saveList(testList, path, serializeInt), valid);
+
+    int restored[5] = {};
+    int *next = restored;
+    loaded = loadList(path, deserializeInt, &next);
+    UTEST(loaded && loaded->size == 5 && loaded->maxsize == 10 && next == restored + 5, valid);
+    for (int i = 0; loaded && i < 5; i++)
+        UTEST(*(int *) listValue(loaded, i) == vals[4 - i], valid);
+
+    if (loaded)
+        deleteList(&loaded);
+
+    FILE *file = fopen(path, "r+b");
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fclose(file);
+    UTEST(truncate(path, length - 1) == 0, valid);
+    next = restored;
+    UTEST(!loadList(path, deserializeInt, &next), valid);
+
+    clearList(testList);
+    UTEST(saveList(testList, path, serializeInt), valid);
+    loaded = loadList(path, deserializeInt, &next);
+    UTEST(loaded && loaded->size == 0 && loaded->head == -1, valid);
+
+    if (loaded)
+        deleteList(&loaded);
+    deleteList(&testList);
+    UTEST(!loadList("unitTestingDump.dot"), valid);
+    remove(path);
+
+    return valid;
+}
+
+/**
+ * Function that reads the whole file into memory
+ * @param path Path to the file
+ * @param size Place for the size of the file
+ * @return Pointer to the null-terminated contents, nullptr if the file cannot be read
+ */
+
+char *readWholeFile(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return nullptr;
+
+    fseek(file, 0, SEEK_END);
+    *size = (size_t) ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *contents = (char *) calloc(*size + 1, 1);
+    if (contents && fread(contents, 1, *size, file) != *size) {
+        free(contents);
+        contents = nullptr;
+    }
+
+    fclose(file);
+    return contents;
+}
+
+/**
+ * Function that tests dump buffer and text of dumps
+ * @return Lib validity
+ */
+
+bool doDumpBufferTesting() {
+    bool valid = true;
+    dumpBuffer_t buffer = {};
+
+    UTEST(initDumpBuffer(&buffer, nullptr, 4), valid);
+    dumpInteger(&buffer, 0);
+    dumpString(&buffer, " ");
+    dumpInteger(&buffer, -7);
+    dumpString(&buffer, " ");
+    dumpInteger(&buffer, 1234567890123);
+    dumpString(&buffer, " ");
+    dumpInteger(&buffer, -9223372036854775807ll - 1);
+    dumpBytes(&buffer, "", 1);
+
+    const char *expected = "0 -7 1234567890123 -9223372036854775808";
+    UTEST(!buffer.failed && buffer.size == strlen(expected) + 1 && !strcmp(buffer.data, expected), valid);
+    freeDumpBuffer(&buffer);
+
+    const char *path = "unitTestingBuffer.dot";
+    int vals[3] = {5, -12, 300};
+    list_t *testList = createList(4);
+    addToTail(testList, &vals[0]);
+    addToHead(testList, &vals[1]);
+    addToTail(testList, &vals[2]);
+    deleteNode(testList, 0);
+
+    size_t size = 0;
+    dumpList(testList, path, nodeDump);
+    char *contents = readWholeFile(path, &size);
+    UTEST(contents && !strcmp(contents, "digraph {\n"
+                                        "node1[label=\"{{1}|{{VALUE|-12}|{NEXT|2}|{PREVIOUS|-1}}}\",shape=record];\n"
+                                        "node2[label=\"{{2}|{{VALUE|300}|{NEXT|-1}|{PREVIOUS|1}}}\",shape=record];\n"
+                                        "node1 -> node2;\nnode2 -> node1;\n"
+                                        "Head -> node1;\nnode2 -> Tail;\n}"), valid);
+    free(contents);
+
+    listPhysicalDump(testList, path, nodeDumpClear);
+    contents = readWholeFile(path, &size);
+    UTEST(contents && strstr(contents, "<td port=\"node0prev\" border=\"1\" bgcolor=\"indianred1\">EMPTY</td>\n"),
+          valid);
+    UTEST(contents && strstr(contents, "<td port=\"node1next\" border=\"1\" bgcolor=\"cadetblue\">1</td>\n"), valid);
+    UTEST(contents && strstr(contents, "mainNode:node2prev:s -> mainNode:node1prev:s [color=\"firebrick\"];\n"), valid);
+    UTEST(contents && strstr(contents, "empty0 [label=\"0\", shape=box];\nempty3 [label=\"3\", shape=box];\n"
+                                       "empty0 -> empty3;\n}\n;}"), valid);
+    free(contents);
+
+    deleteList(&testList);
+    remove(path);
+
+    return valid;
+}
+
+/**
+ * Function that counts occurrences of the substring
+ * @param str String
+ * @param sub Substring
+ * @return Number of occurrences
+ */
+
+size_t countSubstrings(const char *str, const char *sub) {
+    size_t count = 0;
+
+    for (const char *found = strstr(str, sub); found; found = strstr(found + 1, sub))
+        count++;
+
+    return count;
+}
+
+/**
+ * Function that tests windowed and sampled physical dumps
+ * @return Lib validity
+ */
+
+bool doDumpWindowTesting() {
+    bool valid = true;
+    const char *path = "unitTestingWindow.dot";
+    const long long n = 3 * LIST_CHUNK_SIZE;
+    int *vals = (int *) calloc(n, sizeof(int));
+    list_t *testList = createList();
+
+    for (long long i = 0; i < n; i++) {
+        vals[i] = (int) i;
+        if (i % 2)
+            addToHead(testList, &vals[i]);
+        else
+            addToTail(testList, &vals[i]);
+    }
+    deleteNode(testList, 103);
+    deleteNode(testList, 105);
+
+    dumpOptions_t options = DUMP_ALL;
+    options.firstCell = 100;
+    options.lastCell = 110;
+
+    size_t size = 0;
+    listPhysicalDump(testList, path, nodeDumpClear, &options);
+    char *contents = readWholeFile(path, &size);
+    UTEST(contents && countSubstrings(contents, "next\" border") == 10, valid);
+    UTEST(contents && strstr(contents, "node100next") && !strstr(contents, "node99next") &&
+          !strstr(contents, "node110next"), valid);
+    UTEST(contents && countSubstrings(contents, "<td border=\"0\">...</td>") == 4, valid);
+    UTEST(contents && strstr(contents, "empty105 [label=\"105\", shape=box];\nempty105 -> empty103;\n"), valid);
+    UTEST(contents && strstr(contents, "mainNode:node100next:n -> mainNode:node102next:n"), valid);
+    UTEST(size < 4096, valid);
+    free(contents);
+
+    long long middle = getElementByPosition(testList, 500);
+    options = DUMP_ALL;
+    options.around = middle;
+    options.radius = 3;
+
+    long long *cells = nullptr;
+    UTEST(selectDumpCells(testList, &options, &cells) == 7, valid);
+    UTEST(std::is_sorted(cells, cells + 7) && std::binary_search(cells, cells + 7, middle), valid);
+    for (size_t position = 497; position <= 503; position++)
+        UTEST(std::binary_search(cells, cells + 7, getElementByPosition(testList, position)), valid);
+    free(cells);
+
+    listPhysicalDump(testList, path, nodeDumpClear, &options);
+    contents = readWholeFile(path, &size);
+    UTEST(contents && countSubstrings(contents, "forestgreen") == 6 && countSubstrings(contents, "firebrick") == 6,
+          valid);
+    free(contents);
+
+    options.around = testList->head;
+    UTEST(selectDumpCells(testList, &options, &cells) == 4, valid);
+    free(cells);
+
+    options = DUMP_ALL;
+    options.maxCells = 50;
+    UTEST(selectDumpCells(testList, &options, &cells) == 50, valid);
+    bool stratified = true;
+    for (size_t i = 0; i < 50; i++)
+        stratified = stratified && cells[i] >= (long long) (i * testList->capacity / 50) &&
+                     cells[i] < (long long) ((i + 1) * testList->capacity / 50);
+    UTEST(stratified, valid);
+    free(cells);
+
+    listPhysicalDump(testList, path, nodeDumpClear, &options);
+    contents = readWholeFile(path, &size);
+    UTEST(contents && countSubstrings(contents, "prev\" border") == 50, valid);
+    free(contents);
+
+    deleteList(&testList);
+    free(vals);
+    remove(path);
+
+    return valid;
+}
+
+/**
+ * Function that tests JSON Lines and binary dumps
+ * @return Lib validity
+ */
+
+bool doDumpFormatTesting() {
+    bool valid = true;
+    const char *path = "unitTestingFormat.dump";
+    list_t *testList = createList(100);
+
+    for (long long i = 1; i <= 6; i++)
+        addToTail(testList, (void *) (i * 10));
+    deleteNode(testList, 2);
+    addToHead(testList, (void *) 70);
+
+    dumpOptions_t options = DUMP_ALL;
+    options.format = DUMP_JSON_LINES;
+
+    size_t size = 0;
+    listPhysicalDump(testList, path, nullptr, &options);
+    char *contents = readWholeFile(path, &size);
+    const char *expected = "{\"head\":2,\"tail\":5,\"size\":6,\"capacity\":100,\"maxsize\":100,\"emptyHead\":6}\n";
+    UTEST(contents && !strncmp(contents, expected, strlen(expected)), valid);
+    UTEST(contents && countSubstrings(contents, "\n") == 101, valid);
+    UTEST(contents && strstr(contents, "\n{\"cell\":2,\"value\":70,\"next\":0,\"prev\":-1,\"occupied\":true}\n"), valid);
+    UTEST(contents && strstr(contents, "\n{\"cell\":6,\"value\":0,\"next\":-1,\"prev\":7,\"occupied\":false}\n"),
+          valid);
+    free(contents);
+
+    options.firstCell = 1;
+    options.lastCell = 4;
+    listPhysicalDump(testList, path, nullptr, &options);
+    contents = readWholeFile(path, &size);
+    UTEST(contents && countSubstrings(contents, "\"cell\"") == 3 && strstr(contents, "{\"cell\":1,"), valid);
+    free(contents);
+
+    options.format = DUMP_BINARY;
+    listPhysicalDump(testList, path, nullptr, &options);
+    contents = readWholeFile(path, &size);
+
+    dumpImageHeader_t header = {};
+    if (contents)
+        memcpy(&header, contents, sizeof(header));
+    UTEST(size == sizeof(header) + 3 * 100 * sizeof(long long) + 2 * sizeof(unsigned long long), valid);
+    UTEST(!memcmp(header.magic, LIST_DUMP_MAGIC, sizeof(LIST_DUMP_MAGIC)) && header.head == 2 && header.tail == 5 &&
+          header.size == 6 && header.capacity == 100 && header.maxsize == 100 && header.emptyHead == 6, valid);
+
+    bool same = contents != nullptr;
+    for (long long cell = 0; same && cell < 100; cell++) {
+        long long image[3] = {};
+        for (int array = 0; array < 3; array++)
+            memcpy(&image[array], contents + sizeof(header) + (array * 100 + cell) * sizeof(long long), sizeof(long long));
+
+        same = image[0] == (long long) (uintptr_t) listValue(testList, cell) && image[1] == listNext(testList, cell) &&
+               image[2] == listPrev(testList, cell);
+    }
+    UTEST(same, valid);
+
+    unsigned long long bits = 0;
+    if (contents)
+        memcpy(&bits, contents + sizeof(header) + 300 * sizeof(long long), sizeof(bits));
+    UTEST(bits == 0x3f, valid);
+    free(contents);
+
+    deleteList(&testList);
+    remove(path);
+
+    return valid;
+}
+
+/**
+ * Function that tests dumps in the background
+ * @return Lib validity
+ */
+
+bool doAsyncDumpTesting() {
+    bool valid = true;
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    list_t *testList = createList();
+
+    for (int i = 0; i < 10; i++) {
+        if (i % 3)
+            addToTail(testList, &vals[i]);
+        else
+            addToHead(testList, &vals[i]);
+    }
+    deleteNode(testList, 4);
+
+    UTEST(dumpList(testList, "unitTestingSync.dot", nodeDump), valid);
+    UTEST(listPhysicalDump(testList, "unitTestingSyncPhysical.dot", nodeDumpClear), valid);
+
+    std::future<int> logical = dumpListAsync(testList, "unitTestingAsync.dot", nodeDump);
+    std::future<int> physical = listPhysicalDumpAsync(testList, "unitTestingAsyncPhysical.dot", nodeDumpClear);
+
+    clearList(testList);
+    for (int i = 0; i < 5; i++)
+        addToTail(testList, &vals[i]);
+
+    UTEST(logical.get() == 1 && physical.get() == 1, valid);
+
+    size_t syncSize = 0;
+    size_t asyncSize = 0;
+    char *sync = readWholeFile("unitTestingSync.dot", &syncSize);
+    char *async = readWholeFile("unitTestingAsync.dot", &asyncSize);
+    UTEST(sync && async && syncSize == asyncSize && !memcmp(sync, async, syncSize), valid);
+    free(sync);
+    free(async);
+
+    sync = readWholeFile("unitTestingSyncPhysical.dot", &syncSize);
+    async = readWholeFile("unitTestingAsyncPhysical.dot", &asyncSize);
+    UTEST(sync && async && syncSize == asyncSize && !memcmp(sync, async, syncSize), valid);
+    free(sync);
+    free(async);
+
+    dumpOptions_t options = DUMP_ALL;
+    options.format = DUMP_JSON_LINES;
+    UTEST(listPhysicalDumpAsync(testList, "unitTestingAsyncPhysical.dot", nullptr, &options).get() == 1, valid);
+    UTEST(dumpListAsync(testList, "missing/unitTestingAsync.dot").get() == 0, valid);
+    UTEST(!dumpList(testList, "missing/unitTestingAsync.dot"), valid);
+
+    deleteList(&testList);
+    remove("unitTestingSync.dot");
+    remove("unitTestingAsync.dot");
+    remove("unitTestingSyncPhysical.dot");
+    remove("unitTestingAsyncPhysical.dot");
+
+    return valid;
+}
+
+/**
+ * Example function for SVG dumps which renders characters that must be escaped
+ */
+
+void nodeDumpMarkup(dumpBuffer_t *buffer, list_t *list, long long node) {
+    dumpString(buffer, "<a&b>");
+    dumpInteger(buffer, (long long) (uintptr_t) listValue(list, node));
+}
+
+/**
+ * Function that tests SVG dumps
+ * @return Lib validity
+ */
+
+bool doSvgDumpTesting() {
+    bool valid = true;
+    const char *path = "unitTestingDump.svg";
+    list_t *testList = createList(50);
+
+    for (long long i = 1; i <= 40; i++) {
+        if (i % 2)
+            addToTail(testList, (void *) i);
+        else
+            addToHead(testList, (void *) i);
+    }
+    deleteNode(testList, 10);
+    deleteNode(testList, 12);
+
+    dumpOptions_t options = DUMP_ALL;
+    options.format = DUMP_SVG;
+
+    size_t size = 0;
+    UTEST(dumpList(testList, path, nodeDumpMarkup, &options), valid);
+    char *contents = readWholeFile(path, &size);
+    UTEST(contents && !strncmp(contents, "<svg ", 5) && size > 7 && !strcmp(contents + size - 7, "</svg>\n"), valid);
+    UTEST(contents && countSubstrings(contents, "<rect") == 39 && countSubstrings(contents, "marker-start") == 37,
+          valid);
+    UTEST(contents && countSubstrings(contents, "&lt;a&amp;b&gt;") == 38 && !strstr(contents, "<a&"), valid);
+    UTEST(contents && strstr(contents, ">Head</text>") && strstr(contents, ">Tail</text>"), valid);
+    free(contents);
+
+    UTEST(listPhysicalDump(testList, path, nodeDumpMarkup, &options), valid);
+    contents = readWholeFile(path, &size);
+    UTEST(contents && !strcmp(contents + size - 7, "</svg>\n") && countSubstrings(contents, "<rect") == 51, valid);
+    UTEST(contents && countSubstrings(contents, "forestgreen") == 37 && countSubstrings(contents, "firebrick") == 37,
+          valid);
+    UTEST(contents && countSubstrings(contents, "stroke=\"gray\"") == 11 && !strstr(contents, "..."), valid);
+    free(contents);
+
+    options.firstCell = 5;
+    options.lastCell = 20;
+    UTEST(listPhysicalDump(testList, path, nullptr, &options), valid);
+    contents = readWholeFile(path, &size);
+    UTEST(contents && countSubstrings(contents, "<rect") == 16 && countSubstrings(contents, ">...</text>") == 2, valid);
+    UTEST(contents && strstr(contents, "<g id=\"node5\"") && !strstr(contents, "<g id=\"node4\""), valid);
+    free(contents);
+
+    deleteList(&testList);
+    remove(path);
+
+    return valid;
+}
+
+/**
+ * Function that tests that dot dump of all cells made on several threads is the same as made on one
+ * @return Lib validity
+ */
+
+bool doParallelDumpTesting() {
+    bool valid = true;
+    const long long n = 3 * DUMP_SEGMENT_ITEMS + 123;
+    int *vals = (int *) calloc(n, sizeof(int));
+    list_t *testList = createList();
+
+    for (long long i = 0; i < n; i++) {
+        vals[i] = (int) (i * 7919 % 100003);
+        if (i % 3)
+            addToTail(testList, &vals[i]);
+        else
+            addToHead(testList, &vals[i]);
+    }
+    for (long long i = 0; i < n; i += 2)
+        deleteNode(testList, i);
+
+    UTEST(listPhysicalDump(testList, "unitTestingSequential.dot", nodeDumpClear), valid);
+
+    dumpOptions_t options = DUMP_ALL;
+    size_t sequentialSize = 0;
+    char *sequential = readWholeFile("unitTestingSequential.dot", &sequentialSize);
+
+    for (unsigned threads = 0; threads <= 4; threads++) {
+        options.threads = threads;
+        UTEST(listPhysicalDump(testList, "unitTestingParallel.dot", nodeDumpClear, &options), valid);
+
+        size_t parallelSize = 0;
+        char *parallel = readWholeFile("unitTestingParallel.dot", &parallelSize);
+        UTEST(sequential && parallel && sequentialSize == parallelSize && !memcmp(sequential, parallel, parallelSize),
+              valid);
+        free(parallel);
+    }
+
+    std::vector<dumpSegment_t> segments;
+    collectDumpSegments(testList, DUMP_SEGMENT_ITEMS, true, &segments);
+    size_t step = DUMP_SEGMENT_ITEMS;
+    size_t cells = testList->capacity;
+    UTEST(segments.size() == 7 + 2 * ((cells + step - 1) / step) + 2 * ((testList->size + step - 2) / step) +
+                             (cells - testList->size + step - 2) / step, valid);
+
+    free(sequential);
+    deleteList(&testList);
+    free(vals);
+    remove("unitTestingSequential.dot");
+    remove("unitTestingParallel.dot");
+
+    return valid;
+}
+
+/**
+ * Function that tests clustered dumps
+ * @return Lib validity
+ */
+
+bool doClusterDumpTesting() {
+    bool valid = true;
+    int vals[100] = {};
+    list_t *testList = createList();
+    dumpOptions_t options = DUMP_ALL;
+    options.clustered = true;
+    size_t size = 0;
+
+    for (int i = 0; i < 100; i++) {
+        vals[i] = i;
+        addToTail(testList, &vals[i]);
+    }
+
+    UTEST(dumpList(testList, "unitTestingClusters.dot", nodeDump, &options), valid);
+    char *contents = readWholeFile("unitTestingClusters.dot", &size);
+    UTEST(contents && strstr(contents, "cluster0[label=\"{{0..99}|{positions 0..99}|{100 nodes}}\"") &&
+          countSubstrings(contents, "shape=record") == 1, valid);
+    free(contents);
+
+    cellRun_t *runs = nullptr;
+    size_t count = collectCellRuns(testList, &runs);
+    UTEST(count == 2 && runs[0].first == 0 && runs[0].last == 99 && runs[0].occupied && !runs[0].descending &&
+          runs[1].first == 100 && runs[1].last == (long long) testList->pool->capacity - 1 && !runs[1].occupied,
+          valid);
+    UTEST(findCellRun(runs, count, 57) == 0 && findCellRun(runs, count, 100) == 1 &&
+          findCellRun(runs, count, 4000) == 1, valid);
+    free(runs);
+
+    insertAfter(testList, 49, &vals[0]);
+    deleteNode(testList, 80);
+
+    UTEST(dumpList(testList, "unitTestingClusters.dot", nodeDump, &options), valid);
+    contents = readWholeFile("unitTestingClusters.dot", &size);
+    UTEST(contents && countSubstrings(contents, "shape=record") == 4 &&
+          strstr(contents, "cluster1[label=\"{{100}|{{VALUE|0}|{NEXT|50}") &&
+          strstr(contents, "cluster2[label=\"{{50..79}|{positions 51..80}|{30 nodes}}\"") &&
+          strstr(contents, "cluster3 -> Tail;"), valid);
+    free(contents);
+
+    UTEST(listPhysicalDump(testList, "unitTestingClusters.dot", nodeDumpClear, &options), valid);
+    contents = readWholeFile("unitTestingClusters.dot", &size);
+    UTEST(contents && countSubstrings(contents, "<td port=") == 6 &&
+          strstr(contents, "<td port=\"run2\" border=\"1\" bgcolor=\"indianred1\">80<br/>") &&
+          strstr(contents, "mainNode:run0:n -> mainNode:run4:n") && strstr(contents, "mainNode:run4:s -> mainNode:run0:s") &&
+          strstr(contents, "mainNode:run1:n -> mainNode:run3:n") && strstr(contents, "mainNode:run2:s -> mainNode:run5:s"),
+          valid);
+    free(contents);
+
+    deleteList(&testList);
+    remove("unitTestingClusters.dot");
+
+    return valid;
+}
+
+/**
+ * Function that performs unit testing
+ * @return Lib validity
+ */
+
+bool doUnitTesting() {
+    bool valid = true;
+    list_t *testList = createList(10);
+    UTEST(testList->head == -1, valid);
+    UTEST(testList->tail == -1, valid);
+    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    addToHead(testList, &vals[1]);
+    UTEST(testList->head == 0, valid);
+    UTEST(testList->tail == 0, valid);
+    UTEST(testList->size == 1, valid);
+
+    addToTail(testList, &vals[8]);
+    UTEST(testList->tail == 1, valid);
+    UTEST(testList->head == 0, valid);
+    UTEST(testList->size == 2, valid);
+
+    insertAfter(testList, 1, &vals[9]);
+    UTEST(testList->size == 3, valid);
+    UTEST(testList->tail == 2, valid);
+    UTEST(testList->head == 0, valid);
+
+    insertBefore(testList, 0, &vals[0]);
+    UTEST(testList->size == 4, valid);
+    UTEST(testList->tail == 2, valid);
+    UTEST(testList->head == 3, valid);
+
+    UTEST(getElementByPosition(testList, 0) == 3, valid);
+    UTEST(getElementByPosition(testList, 1) == 0, valid);
+    UTEST(getElementByPosition(testList, 2) == 1, valid);
+    UTEST(getElementByPosition(testList, 3) == 2, valid);
+
+    for (int i = 2; i < 8; i++) {
+        insertAfter(testList, getElementByPosition(testList, i - 1), &vals[i]);
+        UTEST(listValue(testList, getElementByPosition(testList, i)) == &vals[i], valid);
+    }
+
+    UTEST(testList->size == 10, valid);
+    UTEST(!addToHead(testList, nullptr), valid);
+    UTEST(!addToTail(testList, nullptr), valid);
+    UTEST(!insertAfter(testList, 0, nullptr), valid);
+    UTEST(!insertBefore(testList, 0, nullptr), valid);
+
+    deleteNode(testList, 3);
+    UTEST(testList->size == 9, valid);
+    UTEST(testList->head == 0, valid);
+
+    deleteNode(testList, 2);
+    UTEST(testList->size == 8, valid);
+    UTEST(testList->tail == 1, valid);
+
+    UTEST(validateList(testList) == OK, valid);
+    listPhysicalDump(testList, "unitTestingPhysical.dot", nodeDumpClear);
+    sortList(testList);
+    UTEST(testList->linearPrefix == 8, valid);
+    UTEST(getElementByPosition(testList, 5) == 5, valid);
+    UTEST(addToTail(testList, &vals[0]), valid);
+    UTEST(testList->linearPrefix == 9, valid);
+    insertAfter(testList, 3, &vals[1]);
+    UTEST(testList->linearPrefix == 4, valid);
+    UTEST(getElementByPosition(testList, 4) == 9, valid);
+    UTEST(getElementByPosition(testList, 5) == 4, valid);
+    UTEST(getElementByPosition(testList, 9) == 8, valid);
+    deleteNode(testList, 9);
+    deleteNode(testList, 8);
+    UTEST(testList->linearPrefix == 4, valid);
+    UTEST(validateList(testList) == OK, valid);
+    listPhysicalDump(testList, "unitTestingSortedPhysical.dot", nodeDumpClear);
+    dumpList(testList, "unitTestingDump.dot", nodeDump);
+    deleteList(&testList);
+    UTEST(!testList, valid);
+
+    list_t *growingList = createList();
+    UTEST(growingList->capacity == 0, valid);
+
+    for (size_t i = 0; i < 3 * LIST_CHUNK_SIZE; i++) {
+        UTEST(addToTail(growingList, &vals[i % 10]), valid);
+    }
+
+    UTEST(growingList->size == 3 * LIST_CHUNK_SIZE, valid);
+    UTEST(growingList->capacity == 3 * LIST_CHUNK_SIZE, valid);
+    UTEST(growingList->chunks == 3, valid);
+    UTEST(getElementByPosition(growingList, LIST_CHUNK_SIZE + 5) == LIST_CHUNK_SIZE + 5, valid);
+
+    void **firstChunk = &listValue(growingList, 0);
+    addToHead(growingList, &vals[0]);
+    UTEST(&listValue(growingList, 0) == firstChunk, valid);
+    UTEST(growingList->head == 3 * LIST_CHUNK_SIZE, valid);
+    UTEST(listNext(growingList, growingList->head) == 0, valid);
+    UTEST(validateList(growingList) == OK, valid);
+
+    deleteNode(growingList, 7);
+    UTEST(addToTail(growingList, &vals[3]), valid);
+    UTEST(growingList->tail == 7, valid);
+    deleteList(&growingList);
+
+    valid = doJumpIndexTesting() && valid;
+    valid = doRangeTesting() && valid;
+    valid = doBatchDeletionTesting() && valid;
+    valid = doSpliceTesting() && valid;
+    valid = doSortByTesting() && valid;
+    valid = doKeyTesting() && valid;
+    valid = doPhysicalScanTesting() && valid;
+    valid = doConcurrentSlotsTesting() && valid;
+    valid = doQueueTesting() && valid;
+    valid = doRingTesting() && valid;
+    valid = doMappedTesting() && valid;
+    valid = doSnapshotTesting() && valid;
+    valid = doDumpBufferTesting() && valid;
+    valid = doDumpWindowTesting() && valid;
+    valid = doDumpFormatTesting() && valid;
+    valid = doAsyncDumpTesting() && valid;
+    valid = doSvgDumpTesting() && valid;
+    valid = doParallelDumpTesting() && valid;
+    valid = doClusterDumpTesting() && valid;
+    valid = doTypedUnitTesting<soaLayout<int>>() && valid;
+    valid = doTypedUnitTesting<aosLayout<int>>() && valid;
+    valid = doTypedUnitTesting<soaLayout<int, uint16_t>>() && valid;
+    valid = doTypedUnitTesting<aosLayout<int, listIndexFor<10>::type>>() && valid;
+    UTEST(sizeof(listIndexFor<10>::type) == 2, valid);
+    UTEST(sizeof(listIndexFor<100000>::type) == 4, valid);
+    UTEST(sizeof(listIndexFor<5000000000ull>::type) == 8, valid);
+    UTEST(maxCellsFor<uint16_t>() == 65534, valid);
+    return valid;
+}
+
+
+const size_t BENCH_LIST_SIZE = 1 << 22;
+
+const int BENCH_TRAVERSALS = 10;
+
+const size_t BENCH_DUMP_SIZE = 10000000;
+
+/**
+ * Function that returns size of the file
+ * @param path Path to the file
+ * @return Size in bytes, 0 if the file can't be opened
+ */
+
+size_t benchFileSize(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return 0;
+
+    fseek(file, 0, SEEK_END);
+    size_t size = (size_t) ftell(file);
+    fclose(file);
+
+    return size;
+}
+
+/**
+ * Function that returns time in seconds passed since the given moment
+ * @param start Starting moment
+ * @return Seconds
+ */
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Xorshift pseudo-random generator used to make benchmarks reproducible
+ * @param state Pointer to generator state
+ * @return Next pseudo-random number
+ */
+
+unsigned long long benchRandom(unsigned long long *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * Function that measures insert and traversal throughput of the typed list with the given layout
+ * @param name Layout name
+ * @param targets Physical numbers of elements to insert after, targets[i] < i
+ * @param n Number of elements
+ */
+
+template<typename Layout>
+void benchmarkLayout(const char *name, const long long *targets, size_t n) {
+    typedList_t<long long, Layout> *list = createTypedList<long long, Layout>(n);
+
+    auto start = std::chrono::steady_clock::now();
+    addToTail(list, 0LL);
+    for (size_t i = 1; i < n; i++)
+        insertAfter(list, targets[i], (long long) i);
+    double insertTime = secondsSince(start);
+
+    long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_TRAVERSALS; i++) {
+        for (long long node = list->head; node != -1; node = listNext(list, node))
+            checksum += listValue(list, node);
+    }
+    double traversalTime = secondsSince(start);
+
+    printf("%s: insert %.2f Mops/s, traversal %.2f Mnodes/s (checksum %lld)\n", name,
+           n / insertTime / 1e6, n * BENCH_TRAVERSALS / traversalTime / 1e6, checksum);
+
+    deleteList(&list);
+}
+
+/**
+ * Function that measures insert and traversal throughput of list_t with the cell layout it was
+ * built with: separate arrays by default, listCell_t records with LIST_AOS_CELLS
+ * @param targets Physical numbers of elements to insert after, targets[i] < i
+ * @param n Number of elements
+ */
+
+void benchmarkListCells(const long long *targets, size_t n) {
+#ifdef LIST_AOS_CELLS
+    const char *name = "list_t, AoS (LIST_AOS_CELLS)";
+#else
+    const char *name = "list_t, SoA";
+#endif
+    list_t *list = createList(n);
+
+    auto start = std::chrono::steady_clock::now();
+    addToTail(list, (void *) 0);
+    for (size_t i = 1; i < n; i++)
+        insertAfter(list, targets[i], (void *) i);
+    double insertTime = secondsSince(start);
+
+    long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_TRAVERSALS; i++) {
+        for (long long node = list->head; node != -1; node = listNext(list, node))
+            checksum += (long long) listValue(list, node);
+    }
+    double traversalTime = secondsSince(start);
+
+    printf("%s: insert %.2f Mops/s, traversal %.2f Mnodes/s (checksum %lld)\n", name,
+           n / insertTime / 1e6, n * BENCH_TRAVERSALS / traversalTime / 1e6, checksum);
+
+    deleteList(&list);
+}
+
+/**
+ * Function that measures positional lookups on a fragmented list with and without jump index
+ * @param n Number of elements
+ * @param lookups Number of lookups
+ */
+
+void benchmarkPositions(size_t n, size_t lookups) {
+    list_t *list = createList();
+    unsigned long long state = 4417;
+
+    for (size_t i = 0; i < n; i++) {
+        if (i % 2)
+            addToHead(list, nullptr);
+        else
+            addToTail(list, nullptr);
+    }
+
+    for (int useIndex = 0; useIndex < 2; useIndex++) {
+        if (useIndex)
+            enableJumpIndex(list);
+
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; i++)
+            checksum += getElementByPosition(list, benchRandom(&state) % n);
+        double time = secondsSince(start);
+
+        printf("%s: %.2f lookups/ms (checksum %lld)\n", useIndex ? "Jump index" : "Walk from head",
+               lookups / time / 1e3, checksum);
+    }
+
+    printf("Jump index hits %zu, rebuilds %zu\n", list->jump->hits, list->jump->rebuilds);
+    deleteList(&list);
+}
+
+/**
+ * Function that compares bulk insertion with insertion of values one by one
+ * @param n Number of elements
+ */
+
+void benchmarkRanges(size_t n) {
+    void **values = (void **) calloc(n, sizeof(void *));
+
+    for (size_t i = 0; i < n; i++)
+        values[i] = values + i;
+
+    list_t *list = createList();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++)
+        addToTail(list, values[i]);
+    printf("addToTail: %.2f Mops/s\n", n / secondsSince(start) / 1e6);
+    deleteList(&list);
+
+    list = createList();
+    start = std::chrono::steady_clock::now();
+    appendRange(list, values, n);
+    printf("appendRange: %.2f Mops/s\n", n / secondsSince(start) / 1e6);
+    deleteList(&list);
+
+    free(values);
+}
+
+/**
+ * Function that compares sortListBy with sorting through an exported array
+ * @param n Number of elements
+ */
+
+void benchmarkSortBy(size_t n) {
+    int *keys = (int *) calloc(n, sizeof(int));
+    void **values = (void **) calloc(n, sizeof(void *));
+    unsigned long long state = 4417;
+
+    for (size_t i = 0; i < n; i++)
+        keys[i] = (int) (benchRandom(&state) % 1000000);
+
+    for (int mode = 0; mode < 2; mode++) {
+        list_t *list = createList();
+
+        for (size_t i = 0; i < n; i++) {
+            if (i % 2)
+                addToHead(list, &keys[i]);
+            else
+                addToTail(list, &keys[i]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (mode == 0) {
+            sortListBy(list, compareInts);
+        } else {
+            long long node = list->head;
+            for (size_t i = 0; i < n; i++) {
+                values[i] = listValue(list, node);
+                node = listNext(list, node);
+            }
+
+            qsort(values, n, sizeof(void *), [](const void *a, const void *b) {
+                return compareInts(*(void **) a, *(void **) b);
+            });
+
+            clearList(list);
+            appendRange(list, values, n);
+        }
+
+        printf("%s: %.2f s\n", mode ? "Export, qsort and rebuild" : "sortListBy", secondsSince(start));
+        deleteList(&list);
+    }
+
+    free(values);
+    free(keys);
+}
+
+/**
+ * Function that measures scaling of sortListParallel from one thread to all cores
+ * @param n Number of elements
+ */
+
+void benchmarkParallelSort(size_t n) {
+    int *keys = (int *) calloc(n, sizeof(int));
+    unsigned long long state = 4417;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < n; i++)
+        keys[i] = (int) (benchRandom(&state) % 1000000);
+
+    std::vector<unsigned> counts;
+
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(cores);
+
+    for (unsigned threads : counts) {
+        list_t *list = createList();
+
+        for (size_t i = 0; i < n; i++)
+            addToTail(list, &keys[i]);
+
+        auto start = std::chrono::steady_clock::now();
+        sortListParallel(list, compareInts, threads);
+        printf("sortListParallel, %u threads: %.2f s\n", threads, secondsSince(start));
+
+        deleteList(&list);
+    }
+
+    free(keys);
+}
+
+/**
+ * Function that compares search through comparator with SIMD scan of inline keys.
+ * The key is absent first, so both searches visit every node, then it is put into the tail
+ * @param n Number of elements
+ * @param scans Number of searches
+ */
+
+void benchmarkKeyScan(size_t n, size_t scans) {
+    long long *keys = (long long *) calloc(n, sizeof(long long));
+    list_t *list = createList();
+    unsigned long long state = 4417;
+
+    enableKeys(list);
+
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = (long long) (benchRandom(&state) % 1000000);
+
+        if (i % 2)
+            addToHead(list, &keys[i]);
+        else
+            addToTail(list, &keys[i]);
+
+        setNodeKey(list, i, keys[i]);
+    }
+
+    long long missing = -1;
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scans; i++)
+        checksum += findFirstNode(list, &missing, [](void *value, void *key) {
+            return *(long long *) value == *(long long *) key;
+        });
+    printf("findFirstNode: %.2f ms per scan (checksum %lld)\n", secondsSince(start) / scans * 1e3, checksum);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scans; i++)
+        checksum += findFirstKey(list, missing);
+    printf("findFirstKey: %.2f ms per scan (checksum %lld)\n", secondsSince(start) / scans * 1e3, checksum);
+
+    long long present = -2;
+    *(long long *) listValue(list, list->tail) = present;
+    setNodeKey(list, list->tail, present);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scans; i++)
+        checksum += findFirstNode(list, &present, [](void *value, void *key) {
+            return *(long long *) value == *(long long *) key;
+        });
+    printf("findFirstNode, key at the tail: %.2f ms per scan (checksum %lld)\n", secondsSince(start) / scans * 1e3,
+           checksum);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scans; i++)
+        checksum += findFirstKey(list, present);
+    printf("findFirstKey, key at the tail: %.2f ms per scan (checksum %lld)\n", secondsSince(start) / scans * 1e3,
+           checksum);
+
+    deleteList(&list);
+    free(keys);
+}
+
+/**
+ * Function that compares counting matches by following links with countIf in physical order
+ * @param n Number of elements
+ */
+
+void benchmarkPhysicalScan(size_t n) {
+    int *values = (int *) calloc(n, sizeof(int));
+    list_t *list = createList();
+    unsigned long long state = 4417;
+
+    for (size_t i = 0; i < n; i++) {
+        values[i] = (int) (benchRandom(&state) % 1000000);
+
+        if (i % 2)
+            addToHead(list, &values[i]);
+        else
+            addToTail(list, &values[i]);
+    }
+
+    long long targets[4] = {1, 1000, 100000, 500000};
+    deleteNodes(list, targets, 4);
+
+    int divisor = 3;
+    size_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long node = list->head; node != -1; node = listNext(list, node))
+        count += isDivisible(listValue(list, node), &divisor);
+    printf("Walk by links: %.2f ms (count %zu)\n", secondsSince(start) * 1e3, count);
+
+    start = std::chrono::steady_clock::now();
+    count = countIf(list, isDivisible, &divisor);
+    printf("countIf: %.2f ms (count %zu)\n", secondsSince(start) * 1e3, count);
+
+    deleteList(&list);
+    free(values);
+}
+
+/**
+ * Function that measures claims and releases of concurrent slots from 1 producer to all cores.
+ * Every producer claims a batch of cells and releases it again, with and without magazines
+ * @param n Number of cells in the pool
+ * @param operations Number of claims per producer
+ */
+
+void benchmarkConcurrentSlots(size_t n, size_t operations) {
+    const size_t batch = 256;
+    list_t *list = createList();
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    while (list->capacity < n)
+        growList(list);
+    enableConcurrentSlots(list);
+
+    std::vector<unsigned> counts;
+
+    for (unsigned producers = 1; producers < cores; producers *= 2)
+        counts.push_back(producers);
+    counts.push_back(cores);
+
+    for (int useMagazine = 0; useMagazine < 2; useMagazine++) {
+        for (unsigned producers : counts) {
+            std::vector<std::thread> workers;
+            auto start = std::chrono::steady_clock::now();
+
+            for (unsigned producer = 0; producer < producers; producer++) {
+                workers.emplace_back([&]() {
+                    slotMagazine_t magazine = {};
+                    slotMagazine_t *own = useMagazine ? &magazine : nullptr;
+                    long long cells[batch] = {};
+
+                    for (size_t done = 0; done < operations; done += batch) {
+                        for (size_t i = 0; i < batch; i++)
+                            cells[i] = claimSlot(list, own);
+                        for (size_t i = 0; i < batch; i++)
+                            releaseSlot(list, cells[i], own);
+                    }
+
+                    if (own)
+                        flushMagazine(list, own);
+                });
+            }
+
+            for (std::thread &worker : workers)
+                worker.join();
+
+            double time = secondsSince(start);
+            printf("%s, %u producers: %.2f Mclaims/s\n", useMagazine ? "Magazines" : "Shared stack", producers,
+                   producers * operations / time / 1e6);
+        }
+    }
+
+    deleteList(&list);
+}
+
+/**
+ * Function that compares queue mode with a list guarded by mutex. Producers enqueue n values
+ * each while one consumer takes them, producers scale from 1 to all cores
+ * @param n Number of values per producer
+ */
+
+void benchmarkQueue(size_t n) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+
+    for (unsigned producers = 1; producers < cores; producers *= 2)
+        counts.push_back(producers);
+    counts.push_back(cores);
+
+    for (int useQueue = 0; useQueue < 2; useQueue++) {
+        for (unsigned producers : counts) {
+            list_t *list = createList();
+            std::mutex lock;
+            std::atomic<double> enqueueTime(0);
+            std::vector<std::thread> workers;
+
+            while (list->capacity < producers * n + 1)
+                growList(list);
+            if (useQueue)
+                enableQueueMode(list);
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (unsigned producer = 0; producer < producers; producer++) {
+                workers.emplace_back([&]() {
+                    slotMagazine_t magazine = {};
+                    auto begin = std::chrono::steady_clock::now();
+
+                    for (size_t i = 0; i < n; i++) {
+                        if (useQueue) {
+                            while (!enqueue(list, list, &magazine))
+                                std::this_thread::yield();
+                        } else {
+                            std::lock_guard<std::mutex> guard(lock);
+                            addToTail(list, list);
+                        }
+                    }
+
+                    double time = secondsSince(begin);
+                    double total = enqueueTime.load();
+                    while (!enqueueTime.compare_exchange_weak(total, total + time));
+
+                    if (useQueue)
+                        flushMagazine(list, &magazine);
+                });
+            }
+
+            slotMagazine_t magazine = {};
+            void *value = nullptr;
+
+            for (size_t taken = 0; taken < producers * n;) {
+                if (useQueue) {
+                    taken += dequeue(list, &value, &magazine);
+                } else {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (list->head != -1) {
+                        deleteNode(list, list->head);
+                        taken++;
+                    }
+                }
+            }
+
+            for (std::thread &worker : workers)
+                worker.join();
+
+            double time = secondsSince(start);
+            printf("%s, %u producers: %.1f ns per enqueue, %.2f Mvalues/s through\n",
+                   useQueue ? "Queue mode" : "Mutex and addToTail", producers,
+                   enqueueTime.load() / (producers * n) * 1e9, producers * n / time / 1e6);
+
+            if (useQueue)
+                flushMagazine(list, &magazine);
+            deleteList(&list);
+        }
+    }
+}
+
+/**
+ * Function that measures single-producer single-consumer pipelines: ring mode with single
+ * and batched pushes against queue mode
+ * @param n Number of values
+ * @param capacity Capacity of the ring
+ */
+
+void benchmarkRing(size_t n, size_t capacity) {
+    const size_t batches[2] = {1, 32};
+
+    for (size_t batch : batches) {
+        list_t *list = createList(capacity);
+        enableRingMode(list);
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread producer([&]() {
+            void *values[32] = {};
+
+            for (size_t pushed = 0; pushed < n;) {
+                size_t count = ringPush(list, values, std::min(batch, n - pushed));
+                if (count == 0)
+                    std::this_thread::yield();
+                pushed += count;
+            }
+        });
+
+        void *values[32] = {};
+        for (size_t popped = 0; popped < n;) {
+            size_t count = ringPop(list, values, batch);
+            if (count == 0)
+                std::this_thread::yield();
+            popped += count;
+        }
+
+        producer.join();
+        printf("Ring mode, batches of %zu: %.2f Mvalues/s\n", batch, n / secondsSince(start) / 1e6);
+        deleteList(&list);
+    }
+
+    list_t *list = createList(capacity);
+    enableQueueMode(list);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        slotMagazine_t magazine = {};
+
+        for (size_t pushed = 0; pushed < n;) {
+            if (enqueue(list, list, &magazine))
+                pushed++;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    slotMagazine_t magazine = {};
+    void *value = nullptr;
+    for (size_t popped = 0; popped < n;) {
+        if (dequeue(list, &value, &magazine))
+            popped++;
+        else
+            std::this_thread::yield();
+    }
+
+    producer.join();
+    printf("Queue mode: %.2f Mvalues/s\n", n / secondsSince(start) / 1e6);
+    flushMagazine(list, &magazine);
+    deleteList(&list);
+}
+
+/**
+ * Function that compares reopening a mapped list with building the list again
+ * @param n Number of elements
+ */
+
+void benchmarkMapped(size_t n) {
+    const char *path = "benchMapped.list";
+    void **values = (void **) calloc(n, sizeof(void *));
+
+    for (size_t i = 0; i < n; i++)
+        values[i] = (void *) i;
+
+    auto start = std::chrono::steady_clock::now();
+    list_t *list = createList(n);
+    appendRange(list, values, n);
+    printf("Build with appendRange: %.2f ms\n", secondsSince(start) * 1e3);
+    deleteList(&list);
+
+    list = createListMapped(path, n);
+    appendRange(list, values, n);
+    deleteList(&list);
+
+    start = std::chrono::steady_clock::now();
+    list = openListMapped(path);
+    printf("openListMapped: %.3f ms\n", secondsSince(start) * 1e3);
+
+    size_t count = 0;
+    for (long long node = list->head; node != -1; node = listNext(list, node))
+        count++;
+    printf("openListMapped and first traversal: %.2f ms (%zu nodes)\n", secondsSince(start) * 1e3, count);
+
+    deleteList(&list);
+    remove(path);
+    free(values);
+}
+
+/**
+ * Function that measures throughput of saveList and loadList with handles and with serializer
+ * @param n Number of elements
+ */
+
+void benchmarkSnapshot(size_t n) {
+    const char *path = "benchSnapshot.bin";
+    int *values = (int *) calloc(n, sizeof(int));
+    int *restored = (int *) calloc(n, sizeof(int));
+    unsigned long long state = 4417;
+
+    for (int useSerializer = 0; useSerializer < 2; useSerializer++) {
+        list_t *list = createList();
+
+        for (size_t i = 0; i < n; i++) {
+            values[i] = (int) (benchRandom(&state) % 1000000);
+            void *value = useSerializer ? (void *) &values[i] : (void *) (uintptr_t) values[i];
+
+            if (i % 2)
+                addToHead(list, value);
+            else
+                addToTail(list, value);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        saveList(list, path, useSerializer ? serializeInt : nullptr);
+        double saveTime = secondsSince(start);
+
+        FILE *file = fopen(path, "rb");
+        fseek(file, 0, SEEK_END);
+        double megabytes = ftell(file) / 1e6;
+        fclose(file);
+
+        int *next = restored;
+        start = std::chrono::steady_clock::now();
+        list_t *loaded = loadList(path, useSerializer ? deserializeInt : nullptr, &next);
+        double loadTime = secondsSince(start);
+
+        printf("%s: %.1f MB, save %.2f ms (%.0f MB/s), load %.2f ms (%.0f MB/s)\n",
+               useSerializer ? "Serializer" : "Handles", megabytes, saveTime * 1e3, megabytes / saveTime,
+               loadTime * 1e3, megabytes / loadTime);
+
+        deleteList(&loaded);
+        deleteList(&list);
+    }
+
+    remove(path);
+    free(values);
+    free(restored);
+}
+
+/**
+ * Example function for dumpListStdio, renders value into a static string like before dumpBuffer_t
+ */
+
+char *nodeDumpStdio(list_t *list, long long node) {
+    static char str[65] = "";
+    sprintf(str, "{VALUE|%d}|{NEXT|%lld}|{PREVIOUS|%lld}", *(int *) listValue(list, node), listNext(list, node),
+            listPrev(list, node));
+    return (char *) str;
+}
+
+/**
+ * Function that dumps list with several fprintf calls per node like dumpList did before dumpBuffer_t.
+ * It is kept as the baseline of benchmarkDump
+ * @param list Pointer to list
+ * @param dumpFilename Dump filename
+ * @param nodeDump Function that renders value
+ */
+
+void dumpListStdio(list_t *list, const char *dumpFilename, char *(*nodeDump)(list_t *, long long)) {
+    FILE *dumpFile = fopen(dumpFilename, "w");
+    fprintf(dumpFile, "digraph {\n");
+
+    long long node = list->head;
+
+    fprintf(dumpFile, "node%lld[label=\"{{%lld}", node, node);
+    fprintf(dumpFile, "|{%s}", (*nodeDump)(list, node));
+    fprintf(dumpFile, "}\",shape=record];\n");
+
+    while (node != list->tail) {
+        fprintf(dumpFile, "node%lld[label=\"{{%lld}", listNext(list, node), listNext(list, node));
+        fprintf(dumpFile, "|{%s}", (*nodeDump)(list, listNext(list, node)));
+        fprintf(dumpFile, "}\",shape=record];\n");
+
+        fprintf(dumpFile, "node%lld -> node%lld;\n", node, listNext(list, node));
+        fprintf(dumpFile, "node%lld -> node%lld;\n", listNext(list, node), node);
+        node = listNext(list, node);
+    }
+
+    fprintf(dumpFile, "Head -> node%lld;\n", list->head);
+    fprintf(dumpFile, "node%lld -> Tail;\n", list->tail);
+    fprintf(dumpFile, "}");
+    fclose(dumpFile);
+}
+
+/**
+ * Function that compares dumps through fprintf with dumps through dumpBuffer_t.
+ * Output goes to /dev/null, so only formatting is measured
+ * @param n Number of elements
+ */
+
+void benchmarkDump(size_t n) {
+    const char *path = "/dev/null";
+    int *values = (int *) calloc(n, sizeof(int));
+    list_t *list = createList();
+    unsigned long long state = 4417;
+
+    for (size_t i = 0; i < n; i++) {
+        values[i] = (int) (benchRandom(&state) % 2000000) - 1000000;
+
+        if (i % 2)
+            addToHead(list, &values[i]);
+        else
+            addToTail(list, &values[i]);
+    }
+
+    dumpList(list, "benchDump.dot", nodeDump);
+    FILE *file = fopen("benchDump.dot", "rb");
+    fseek(file, 0, SEEK_END);
+    size_t size = (size_t) ftell(file);
+    fclose(file);
+    remove("benchDump.dot");
+    double megabytes = size / 1e6;
+
+    auto start = std::chrono::steady_clock::now();
+    dumpListStdio(list, path, nodeDumpStdio);
+    double stdioTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    dumpList(list, path, nodeDump);
+    double bufferTime = secondsSince(start);
+
+    printf("dumpList, fprintf: %.0f ms (%.0f MB/s)\n", stdioTime * 1e3, megabytes / stdioTime);
+    printf("dumpList, buffer: %.0f ms (%.0f MB/s), %.1fx faster\n", bufferTime * 1e3, megabytes / bufferTime,
+           stdioTime / bufferTime);
+
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, path, nodeDumpClear);
+    printf("listPhysicalDump, buffer: %.0f ms\n", secondsSince(start) * 1e3);
+
+    dumpOptions_t options = DUMP_ALL;
+    options.around = getElementByPosition(list, n / 2);
+    options.radius = 1000;
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, path, nodeDumpClear, &options);
+    printf("listPhysicalDump, window of %zu nodes: %.2f ms\n", 2 * options.radius + 1, secondsSince(start) * 1e3);
+
+    options = DUMP_ALL;
+    options.maxCells = 10000;
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, path, nodeDumpClear, &options);
+    printf("listPhysicalDump, sample of %zu cells: %.2f ms\n", options.maxCells, secondsSince(start) * 1e3);
+
+    options = DUMP_ALL;
+    options.format = DUMP_JSON_LINES;
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, path, nullptr, &options);
+    printf("listPhysicalDump, JSON Lines: %.0f ms\n", secondsSince(start) * 1e3);
+
+    options.format = DUMP_BINARY;
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, "benchDump.bin", nullptr, &options);
+    double binaryTime = secondsSince(start);
+
+    file = fopen("benchDump.bin", "rb");
+    fseek(file, 0, SEEK_END);
+    megabytes = ftell(file) / 1e6;
+    fclose(file);
+    remove("benchDump.bin");
+    printf("listPhysicalDump, binary to file: %.0f ms (%.0f MB/s)\n", binaryTime * 1e3, megabytes / binaryTime);
+
+    options.format = DUMP_SVG;
+    start = std::chrono::steady_clock::now();
+    dumpList(list, path, nodeDump, &options);
+    printf("dumpList, SVG: %.0f ms\n", secondsSince(start) * 1e3);
+
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, path, nodeDumpClear, &options);
+    printf("listPhysicalDump, SVG: %.0f ms\n", secondsSince(start) * 1e3);
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(cores);
+    if (cores == 1)
+        counts.push_back(2);
+
+    options = DUMP_ALL;
+    for (unsigned threads : counts) {
+        options.threads = threads;
+        start = std::chrono::steady_clock::now();
+        listPhysicalDump(list, path, nodeDumpClear, &options);
+        printf("listPhysicalDump, %u threads: %.0f ms\n", threads, secondsSince(start) * 1e3);
+    }
+
+    start = std::chrono::steady_clock::now();
+    std::future<int> written = listPhysicalDumpAsync(list, path, nodeDumpClear);
+    double returnTime = secondsSince(start);
+    written.wait();
+    printf("listPhysicalDumpAsync: returns after %.0f ms, written after %.0f ms\n", returnTime * 1e3,
+           secondsSince(start) * 1e3);
+
+    options = DUMP_ALL;
+    options.clustered = true;
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, "benchDump.dot", nodeDumpClear, &options);
+    double clusterTime = secondsSince(start);
+    printf("listPhysicalDump, clusters of fragmented list: %.0f ms, %.1f MB\n", clusterTime * 1e3,
+           benchFileSize("benchDump.dot") / 1e6);
+
+    sortList(list);
+    deleteNode(list, list->head + (long long) n / 2);
+    start = std::chrono::steady_clock::now();
+    dumpList(list, "benchDump.dot", nodeDump, &options);
+    clusterTime = secondsSince(start);
+    printf("dumpList, clusters of sorted list: %.0f ms, %zu bytes\n", clusterTime * 1e3, benchFileSize("benchDump.dot"));
+
+    start = std::chrono::steady_clock::now();
+    listPhysicalDump(list, "benchDump.dot", nodeDumpClear, &options);
+    clusterTime = secondsSince(start);
+    printf("listPhysicalDump, clusters of sorted list: %.0f ms, %zu bytes\n", clusterTime * 1e3,
+           benchFileSize("benchDump.dot"));
+    remove("benchDump.dot");
+
+    deleteList(&list);
+    free(values);
+}
+
+/**
+ * Function that runs benchmarks of the list
+ */
+
+void runBenchmarks() {
+    long long *targets = (long long *) calloc(BENCH_LIST_SIZE, sizeof(long long));
+    unsigned long long state = 4417;
+
+    for (size_t i = 1; i < BENCH_LIST_SIZE; i++)
+        targets[i] = benchRandom(&state) % i;
+
+    printf("Cell layouts, %zu fragmented nodes:\n", BENCH_LIST_SIZE);
+    benchmarkLayout<soaLayout<long long>>("SoA", targets, BENCH_LIST_SIZE);
+    benchmarkLayout<aosLayout<long long>>("AoS", targets, BENCH_LIST_SIZE);
+
+    typedef listIndexFor<BENCH_LIST_SIZE>::type benchIndex_t;
+    benchmarkLayout<soaLayout<long long, benchIndex_t>>("SoA, 32-bit links", targets, BENCH_LIST_SIZE);
+    benchmarkLayout<aosLayout<long long, benchIndex_t>>("AoS, 32-bit links", targets, BENCH_LIST_SIZE);
+    benchmarkListCells(targets, BENCH_LIST_SIZE);
+
+    printf("Positional lookups, %zu fragmented nodes:\n", BENCH_LIST_SIZE / 4);
+    benchmarkPositions(BENCH_LIST_SIZE / 4, 1000);
+
+    printf("Bulk insertion, %zu nodes:\n", BENCH_LIST_SIZE);
+    benchmarkRanges(BENCH_LIST_SIZE);
+
+    printf("Sorting by value, %zu fragmented nodes:\n", BENCH_LIST_SIZE / 4);
+    benchmarkSortBy(BENCH_LIST_SIZE / 4);
+
+    printf("Parallel sorting, %zu nodes, %u cores:\n", BENCH_LIST_SIZE, std::thread::hardware_concurrency());
+    benchmarkParallelSort(BENCH_LIST_SIZE);
+
+    printf("Key search, %zu fragmented nodes:\n", BENCH_LIST_SIZE);
+    benchmarkKeyScan(BENCH_LIST_SIZE, 20);
+
+    printf("Unordered scan, %zu fragmented nodes:\n", BENCH_LIST_SIZE);
+    benchmarkPhysicalScan(BENCH_LIST_SIZE);
+
+    printf("Concurrent slots, %zu cells, %u cores:\n", BENCH_LIST_SIZE / 4, std::thread::hardware_concurrency());
+    benchmarkConcurrentSlots(BENCH_LIST_SIZE / 4, 1 << 22);
+
+    printf("MPSC queue, %u cores:\n", std::thread::hardware_concurrency());
+    benchmarkQueue(BENCH_LIST_SIZE / 4);
+
+    printf("SPSC pipeline, %zu values:\n", BENCH_LIST_SIZE);
+    benchmarkRing(BENCH_LIST_SIZE, 1024);
+
+    printf("Mapped list, %zu nodes:\n", BENCH_LIST_SIZE);
+    benchmarkMapped(BENCH_LIST_SIZE);
+
+    printf("Snapshots, %zu fragmented nodes:\n", BENCH_LIST_SIZE);
+    benchmarkSnapshot(BENCH_LIST_SIZE);
+
+    printf("Dumps, %zu fragmented nodes:\n", BENCH_DUMP_SIZE);
+    benchmarkDump(BENCH_DUMP_SIZE);
+
+    free(targets);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !strcmp(argv[1], "--bench")) {
+        runBenchmarks();
+        return 0;
+    }
+
+    if (doUnitTesting())
+        printf(ANSI_COLOR_GREEN "##############################\nUnit testing finished successfully!\n##############################" ANSI_COLOR_RESET);
+    else
+        printf(ANSI_COLOR_RED "##############################\nUnit testing failed!\n##############################" ANSI_COLOR_RESET);
+}
+
+/**
+ * List "constructor" i. e. function that creates and initializes list_t.
+ * Links are 64-bit whatever maxsize is, see list_t
+ * @param maxsize Maximal size of list, LIST_UNBOUNDED if list may grow without limit
+ * @return Pointer to list_t, nullptr if memory cannot be allocated
+ */
+
+list_t *createList(size_t maxsize) {
+    list_t *list = (list_t *) calloc(1, sizeof(list_t));
+    if (!list)
+        return nullptr;
+
+    list->pool = list;
+    list->sharers = 0;
+    list->freeCells = 0;
+    list->size = 0;
+    list->chunks = 0;
+    list->directorySize = 0;
+    list->capacity = 0;
+    list->maxsize = maxsize;
+    list->head = -1;
+    list->tail = -1;
+    list->emptyHead = -1;
+    list->linearPrefix = 0;
+    list->keys = nullptr;
+    list->keyed = nullptr;
+    list->keyMatches = nullptr;
+    list->occupied = nullptr;
+    list->jump = nullptr;
+    list->slots = nullptr;
+    list->queue = nullptr;
+    list->ring = nullptr;
+    list->mapping = nullptr;
+    list->mappedSize = 0;
+    //list->free = {};
+    //stackConstruct(&list->free, "ListFreeStack", maxsize, -1);
+
+    return list;
+}
+
+/**
+ * Function that creates an empty list which takes cells from the pool of another list.
+ * Nodes can be moved between lists with the same pool without copying.
+ * Shared lists must be deleted before the pool list
+ * @param pool Pointer to list_t whose cells are used
+ * @return Pointer to list_t
+ */
+
+list_t *createSharedList(list_t *pool) {
+    assert(pool);
+
+    list_t *list = (list_t *) calloc(1, sizeof(list_t));
+    list->pool = pool->pool;
+    list->pool->sharers++;
+    list->maxsize = list->pool->maxsize;
+    list->size = 0;
+    list->head = -1;
+    list->tail = -1;
+    list->emptyHead = -1;
+    list->linearPrefix = 0;
+    list->jump = nullptr;
+
+    return list;
+}
+
+/**
+ * Function that returns size of the file of the mapped list
+ * @param maxsize Maximal size of the list
+ * @return Size in bytes
+ */
+
+size_t mappedFileSize(size_t maxsize) {
+    size_t cells = (maxsize + LIST_CHUNK_MASK) / LIST_CHUNK_SIZE * LIST_CHUNK_SIZE;
+
+    return LIST_MAPPED_DATA_OFFSET + cells * (sizeof(void *) + 2 * sizeof(long long)) + cells / 8;
+}
+
+/**
+ * Function that points directories of the chunk into the file mapping. Values, next links,
+ * previous links (or listCell_t records with LIST_AOS_CELLS) and occupancy bits of all cells
+ * follow the header one after another
+ * @param list Pointer to mapped list_t
+ * @param chunk Number of chunk, directories must hold it
+ */
+
+void mappedChunk(list_t *list, size_t chunk) {
+    assert(list && list->mapping);
+    assert(chunk < list->directorySize);
+
+    size_t cells = (list->maxsize + LIST_CHUNK_MASK) / LIST_CHUNK_SIZE * LIST_CHUNK_SIZE;
+    char *data = list->mapping + LIST_MAPPED_DATA_OFFSET;
+
+#ifdef LIST_AOS_CELLS
+    list->cells[chunk] = (listCell_t *) data + chunk * LIST_CHUNK_SIZE;
+#else
+    list->value[chunk] = (void **) data + chunk * LIST_CHUNK_SIZE;
+    list->next[chunk] = (long long *) (data + cells * sizeof(void *)) + chunk * LIST_CHUNK_SIZE;
+    list->prev[chunk] = (long long *) (data + cells * (sizeof(void *) + sizeof(long long))) + chunk * LIST_CHUNK_SIZE;
+#endif
+    list->occupied[chunk] = (unsigned long long *) (data + cells * (sizeof(void *) + 2 * sizeof(long long))) +
+                            chunk * (LIST_CHUNK_SIZE / 64);
+}
+
+/**
+ * Function that allocates chunk directories of the mapped list for all chunks it may ever have
+ * and points them into the mapping
+ * @param list Pointer to mapped list_t
+ * @return 0 if allocation error occures, 1 otherwise
+ */
+
+int attachMappedChunks(list_t *list) {
+    assert(list && list->mapping);
+
+    size_t directorySize = (list->maxsize + LIST_CHUNK_MASK) / LIST_CHUNK_SIZE;
+
+#ifdef LIST_AOS_CELLS
+    list->cells = nullptr;
+#else
+    list->value = nullptr;
+    list->next = nullptr;
+    list->prev = nullptr;
+#endif
+    list->occupied = (unsigned long long **) calloc(directorySize, sizeof(unsigned long long *));
+
+    if (!list->occupied || !growCellDirectories(list, directorySize)) {
+        freeCellDirectories(list);
+        free(list->occupied);
+        return 0;
+    }
+
+    list->directorySize = directorySize;
+
+    for (size_t i = 0; i < list->chunks; i++)
+        mappedChunk(list, i);
+
+    return 1;
+}
+
+/**
+ * Function that creates list stored in a file. Header of the list and all its cells live in
+ * a shared file mapping, so changes reach the file without any serialization and
+ * openListMapped gets the list back after restart. Links are physical numbers and stay valid
+ * in any process, but values are stored as they are, so they must be handles (indices, offsets)
+ * or inline data cast to void *, not pointers. Inline keys and jump index are not stored
+ * @param path Path to the file, it is created or truncated
+ * @param maxsize Maximal size of the list, space for all cells is reserved in the file
+ * @return Pointer to list_t, nullptr if the file cannot be created or mapped
+ */
+
+list_t *createListMapped(const char *path, size_t maxsize) {
+    assert(path);
+    assert(maxsize > 0 && maxsize != LIST_UNBOUNDED);
+
+    size_t fileSize = mappedFileSize(maxsize);
+    int file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (file == -1)
+        return nullptr;
+
+    if (ftruncate(file, (off_t) fileSize) != 0) {
+        close(file);
+        return nullptr;
+    }
+
+    void *mapping = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
+
+    if (mapping == MAP_FAILED)
+        return nullptr;
+
+    mappedHeader_t *header = (mappedHeader_t *) mapping;
+    memcpy(header->magic, LIST_MAPPED_MAGIC, sizeof(header->magic));
+    header->headerSize = sizeof(mappedHeader_t);
+    header->fileSize = fileSize;
+
+    list_t *list = &header->list;
+    list->pool = list;
+    list->maxsize = maxsize;
+    list->head = -1;
+    list->tail = -1;
+    list->emptyHead = -1;
+    list->mapping = (char *) mapping;
+    list->mappedSize = fileSize;
+
+    if (!attachMappedChunks(list)) {
+        munmap(mapping, fileSize);
+        return nullptr;
+    }
+
+    return list;
+}
+
+/**
+ * Function that checks fields of the mapped list header which are used before any cell is
+ * touched. Links inside cells are not checked, validateList does it
+ * @param list Pointer to list_t inside the mapping, maxsize is already checked
+ * @return true if chunk count, capacity, sizes and links of the header are consistent
+ */
+
+bool mappedHeaderValid(const list_t *list) {
+    size_t directorySize = (list->maxsize + LIST_CHUNK_MASK) / LIST_CHUNK_SIZE;
+    long long capacity = (long long) list->capacity;
+
+    return list->chunks <= directorySize && list->capacity <= list->maxsize &&
+           list->capacity <= list->chunks * LIST_CHUNK_SIZE && list->size <= list->capacity &&
+           list->linearPrefix <= list->size && list->freeCells <= list->capacity &&
+           list->head >= -1 && list->head < capacity && list->tail >= -1 && list->tail < capacity &&
+           list->emptyHead >= -1 && list->emptyHead < capacity;
+}
+
+/**
+ * Function that opens list created by createListMapped. Only the chunk directories are
+ * allocated, cells are paged in from the file when they are touched
+ * @param path Path to the file
+ * @return Pointer to list_t, nullptr if the file is not a mapped list of this build, was
+ * left in concurrent, queue or ring mode or its header is damaged
+ */
+
+list_t *openListMapped(const char *path) {
+    assert(path);
+
+    int file = open(path, O_RDWR);
+    struct stat status = {};
+
+    if (file == -1)
+        return nullptr;
+
+    if (fstat(file, &status) != 0 || (size_t) status.st_size < sizeof(mappedHeader_t)) {
+        close(file);
+        return nullptr;
+    }
+
+    size_t fileSize = status.st_size;
+    void *mapping = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
+
+    if (mapping == MAP_FAILED)
+        return nullptr;
+
+    mappedHeader_t *header = (mappedHeader_t *) mapping;
+    list_t *list = &header->list;
+
+    if (memcmp(header->magic, LIST_MAPPED_MAGIC, sizeof(header->magic)) != 0 ||
+        header->headerSize != sizeof(mappedHeader_t) || header->fileSize != fileSize ||
+        list->maxsize == LIST_UNBOUNDED || mappedFileSize(list->maxsize) != fileSize ||
+        list->slots || list->queue || list->ring || !mappedHeaderValid(list)) {
+        munmap(mapping, fileSize);
+        return nullptr;
+    }
+
+    list->pool = list;
+    list->sharers = 0;
+    list->keys = nullptr;
+    list->keyed = nullptr;
+    list->keyMatches = nullptr;
+    list->jump = nullptr;
+    list->mapping = (char *) mapping;
+    list->mappedSize = fileSize;
+
+    if (!attachMappedChunks(list)) {
+        munmap(mapping, fileSize);
+        return nullptr;
+    }
+
+    return list;
+}
+
+/**
+ * Function that writes changed pages of the mapped list to the file and waits for it
+ * @param list Pointer to mapped list_t
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int syncListMapped(list_t *list) {
+    assert(list && list->mapping);
+
+    return msync(list->mapping, list->mappedSize, MS_SYNC) == 0;
+}
+
+/**
+ * Function that returns reference to the value of the cell
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @return Reference to the value
+ */
+
+void *&listValue(list_t *list, long long node) {
+#ifdef LIST_AOS_CELLS
+    return list->pool->cells[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK].value;
+#else
+    return list->pool->value[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK];
+#endif
+}
+
+/**
+ * Function that returns reference to the next link of the cell
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @return Reference to the next link
+ */
+
+long long &listNext(list_t *list, long long node) {
+#ifdef LIST_AOS_CELLS
+    return list->pool->cells[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK].next;
+#else
+    return list->pool->next[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK];
+#endif
+}
+
+/**
+ * Function that returns reference to the previous link of the cell
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @return Reference to the previous link
+ */
+
+long long &listPrev(list_t *list, long long node) {
+#ifdef LIST_AOS_CELLS
+    return list->pool->cells[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK].prev;
+#else
+    return list->pool->prev[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK];
+#endif
+}
+
+/**
+ * Function that reallocates chunk directories of values and links
+ * @param list Pointer to pool list_t
+ * @param directorySize New number of chunks the directories can hold
+ * @return 0 if allocation error occures, 1 otherwise
+ */
+
+int growCellDirectories(list_t *list, size_t directorySize) {
+    assert(list);
+
+#ifdef LIST_AOS_CELLS
+    listCell_t **cells = (listCell_t **) realloc(list->cells, directorySize * sizeof(listCell_t *));
+    if (!cells)
+        return 0;
+    list->cells = cells;
+#else
+    void ***value = (void ***) realloc(list->value, directorySize * sizeof(void **));
+    if (!value)
+        return 0;
+    list->value = value;
+
+    long long **next = (long long **) realloc(list->next, directorySize * sizeof(long long *));
+    if (!next)
+        return 0;
+    list->next = next;
+
+    long long **prev = (long long **) realloc(list->prev, directorySize * sizeof(long long *));
+    if (!prev)
+        return 0;
+    list->prev = prev;
+#endif
+
+    return 1;
+}
+
+/**
+ * Function that allocates zeroed values and links of the chunk and puts them into the directories
+ * @param list Pointer to pool list_t
+ * @param chunk Number of chunk, directories must hold it
+ * @param cells Number of cells in the chunk
+ * @return 0 if allocation error occures, 1 otherwise
+ */
+
+int allocateCellChunk(list_t *list, size_t chunk, size_t cells) {
+    assert(list);
+    assert(chunk < list->directorySize);
+
+#ifdef LIST_AOS_CELLS
+    list->cells[chunk] = (listCell_t *) calloc(cells, sizeof(listCell_t));
+
+    return list->cells[chunk] != nullptr;
+#else
+    list->value[chunk] = (void **) calloc(cells, sizeof(void *));
+    list->next[chunk] = (long long *) calloc(cells, sizeof(long long));
+    list->prev[chunk] = (long long *) calloc(cells, sizeof(long long));
+
+    return list->value[chunk] && list->next[chunk] && list->prev[chunk];
+#endif
+}
+
+/**
+ * Function that copies values and links of the chunk from another pool
+ * @param copy Pointer to list_t with allocated chunk
+ * @param pool Pointer to pool list_t
+ * @param chunk Number of chunk
+ * @param cells Number of cells in the chunk
+ */
+
+void copyCellChunk(list_t *copy, list_t *pool, size_t chunk, size_t cells) {
+#ifdef LIST_AOS_CELLS
+    memcpy(copy->cells[chunk], pool->cells[chunk], cells * sizeof(listCell_t));
+#else
+    memcpy(copy->value[chunk], pool->value[chunk], cells * sizeof(void *));
+    memcpy(copy->next[chunk], pool->next[chunk], cells * sizeof(long long));
+    memcpy(copy->prev[chunk], pool->prev[chunk], cells * sizeof(long long));
+#endif
+}
+
+/**
+ * Function that writes values into consecutive cells of one chunk, links are not touched
+ * @param pool Pointer to pool list_t
+ * @param first Physical number of the first cell
+ * @param values Array of n values
+ * @param n Number of cells, they must not cross the end of the chunk
+ */
+
+void storeCellValues(list_t *pool, long long first, void *const *values, size_t n) {
+    assert(pool);
+    assert(first >= 0 && (first & LIST_CHUNK_MASK) + n <= LIST_CHUNK_SIZE);
+
+#ifdef LIST_AOS_CELLS
+    listCell_t *cells = &pool->cells[first >> LIST_CHUNK_SHIFT][first & LIST_CHUNK_MASK];
+
+    for (size_t i = 0; i < n; i++)
+        cells[i].value = values[i];
+#else
+    memcpy(&pool->value[first >> LIST_CHUNK_SHIFT][first & LIST_CHUNK_MASK], values, n * sizeof(void *));
+#endif
+}
+
+/**
+ * Function that frees values and links of the chunk, which is not in a file mapping
+ * @param list Pointer to pool list_t
+ * @param chunk Number of chunk
+ */
+
+void freeCellChunk(list_t *list, size_t chunk) {
+#ifdef LIST_AOS_CELLS
+    free(list->cells[chunk]);
+    list->cells[chunk] = nullptr;
+#else
+    free(list->value[chunk]);
+    free(list->next[chunk]);
+    free(list->prev[chunk]);
+    list->value[chunk] = nullptr;
+    list->next[chunk] = nullptr;
+    list->prev[chunk] = nullptr;
+#endif
+}
+
+/**
+ * Function that frees chunk directories of values and links
+ * @param list Pointer to pool list_t
+ */
+
+void freeCellDirectories(list_t *list) {
+#ifdef LIST_AOS_CELLS
+    free(list->cells);
+    list->cells = nullptr;
+#else
+    free(list->value);
+    free(list->next);
+    free(list->prev);
+    list->value = nullptr;
+    list->next = nullptr;
+    list->prev = nullptr;
+#endif
+}
+
+/**
+ * Function that allocates one more chunk of cells and adds them to the list of the empty cells.
+ * Existing chunks are not moved, only the chunk directory may be reallocated.
+ * Chunks of a mapped list are taken from its file.
+ * The pool does not grow while concurrent slots are enabled
+ * @param list Pointer to list_t, its pool grows
+ * @return 0 if list is full or allocation error occures, 1 otherwise
+ */
+
+int growList(list_t *list) {
+    assert(list);
+
+    list = list->pool;
+
+    if (list->capacity >= list->maxsize || list->slots)
+        return 0;
+
+    if (list->chunks == list->directorySize) {
+        size_t directorySize = list->directorySize ? list->directorySize * 2 : 1;
+
+        if (!growCellDirectories(list, directorySize))
+            return 0;
+
+        unsigned long long **occupied = (unsigned long long **) realloc(list->occupied, directorySize *
+                                                                                       sizeof(unsigned long long *));
+        if (!occupied)
+            return 0;
+        list->occupied = occupied;
+
+        if (list->keys) {
+            long long **keys = (long long **) realloc(list->keys, directorySize * sizeof(long long *));
+            if (!keys)
+                return 0;
+            list->keys = keys;
+
+            unsigned long long **keyed = (unsigned long long **) realloc(list->keyed, directorySize *
+                                                                                      sizeof(unsigned long long *));
+            if (!keyed)
+                return 0;
+            list->keyed = keyed;
+
+            unsigned long long *keyMatches = (unsigned long long *) realloc(list->keyMatches,
+                                                                            keyMatchWords(directorySize) *
+                                                                            sizeof(unsigned long long));
+            if (!keyMatches)
+                return 0;
+            list->keyMatches = keyMatches;
+        }
+
+        list->directorySize = directorySize;
+    }
+
+    size_t added = list->maxsize - list->capacity;
+    if (added > LIST_CHUNK_SIZE)
+        added = LIST_CHUNK_SIZE;
+
+    bool allocated = true;
+
+    if (list->mapping) {
+        mappedChunk(list, list->chunks);
+    } else {
+        list->occupied[list->chunks] = (unsigned long long *) calloc(LIST_CHUNK_SIZE / 64,
+                                                                     sizeof(unsigned long long));
+        allocated = allocateCellChunk(list, list->chunks, added) && list->occupied[list->chunks];
+    }
+
+    if (!allocated || (list->keys && !allocateKeyChunk(list, list->chunks))) {
+        if (!list->mapping) {
+            freeCellChunk(list, list->chunks);
+            free(list->occupied[list->chunks]);
+        }
+        return 0;
+    }
+
+    long long first = list->capacity;
+    list->chunks++;
+
+    for (long long i = added - 1; i >= 0; i--) {
+        listNext(list, first + i) = -1;
+        listPrev(list, first + i) = first + i + 1;
+    }
+    listPrev(list, first + added - 1) = list->emptyHead;
+
+    list->capacity += added;
+    list->freeCells += added;
+    list->emptyHead = first;
+
+    return 1;
+}
+
+/**
+ * Function that clears list
+ * @param list Pointer to list_t
+ */
+
+void clearList(list_t *list) {
+    assert(list);
+
+    long long curNode = list->head;
+    long long next = -1;
+
+    while (curNode != -1) {
+        next = listNext(list, curNode);
+
+        listNext(list, curNode) = -1;
+        listValue(list, curNode) = nullptr;
+        addEmpty(list, curNode);
+        // stackPush(&list->free, curNode);
+
+        curNode = next;
+    }
+
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+    list->linearPrefix = 0;
+
+    invalidateJumpIndex(list);
+}
+
+/**
+ * List "destructor" i. e. function that deletes list.
+ * Mapped list is written to its file and unmapped, the file keeps its nodes
+ * @param list Pointer to pointer to list
+ */
+
+void deleteList(list_t **list) {
+    assert(list);
+    assert(*list);
+
+    disableQueueMode(*list);
+    disableRingMode(*list);
+    if (!(*list)->mapping)
+        clearList(*list);
+    disableJumpIndex(*list);
+
+    //stackDestruct(&(*list)->free);
+
+    if ((*list)->pool != *list) {
+        (*list)->pool->sharers--;
+        free(*list);
+        *list = nullptr;
+        return;
+    }
+
+    assert((*list)->sharers == 0);
+
+    disableConcurrentSlots(*list);
+
+    for (size_t i = 0; i < (*list)->chunks; i++) {
+        if (!(*list)->mapping) {
+            freeCellChunk(*list, i);
+            free((*list)->occupied[i]);
+        }
+
+        if ((*list)->keys) {
+            free((*list)->keys[i]);
+            free((*list)->keyed[i]);
+        }
+    }
+
+    free((*list)->keys);
+    free((*list)->keyed);
+    free((*list)->keyMatches);
+    free((*list)->occupied);
+    freeCellDirectories(*list);
+
+    if ((*list)->mapping) {
+        char *mapping = (*list)->mapping;
+        size_t mappedSize = (*list)->mappedSize;
+
+        msync(mapping, mappedSize, MS_SYNC);
+        munmap(mapping, mappedSize);
+        *list = nullptr;
+        return;
+    }
+
+    free(*list);
+    *list = nullptr;
+}
+
+/**
+ * Function that adds elements to list's head
+ * @param list Pointer to list_t
+ * @param value Void pointer to value
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int addToHead(list_t *list, void *value) {
+    assert(list);
+
+    if (list->size == list->maxsize)
+        return 0;
+
+    long long temp = list->head;
+    long long newNode = getEmpty(list);
+
+    if (newNode == -1)
+        return 0;
+
+    // stackPop(&list->free, &newNode);
+
+    listValue(list, newNode) = value;
+    listNext(list, newNode) = temp;
+
+    if (temp != -1) {
+        listPrev(list, temp) = newNode;
+    }
+
+    list->head = newNode;
+
+    if (list->tail == -1) {
+        list->tail = newNode;
+    }
+
+    list->size++;
+    shrinkLinearPrefix(list, 0);
+    extendLinearPrefix(list, newNode);
+    patchJumpIndexInsert(list, newNode);
+
+    return 1;
+}
+
+/**
+ * Function that returns position of an empty element. List grows if there are no empty cells left
+ * @param list Pointer to list
+ * @return Physical number of empty cell, -1 if there is no room
+ */
+
+long long getEmpty(list_t *list) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (pool->slots) {
+        long long empty = claimSlot(pool);
+        if (empty != -1)
+            markOccupied(pool, empty, true);
+        return empty;
+    }
+
+    if (pool->emptyHead == -1 && !growList(pool))
+        return -1;
+
+    long long empty = pool->emptyHead;
+    pool->emptyHead = listPrev(pool, empty);
+    pool->freeCells--;
+    listPrev(pool, empty) = -1;
+    markOccupied(pool, empty, true);
+    return empty;
+}
+
+/**
+ * Function that adds cell to the list of the empty cells
+ * @param list Pointer to list_t
+ * @param num Physical number of cell
+ */
+
+void addEmpty(list_t *list, long long num) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    clearNodeKey(pool, num);
+    markOccupied(pool, num, false);
+
+    if (pool->slots) {
+        releaseSlot(pool, num);
+        return;
+    }
+
+    listPrev(pool, num) = pool->emptyHead;
+    pool->emptyHead = num;
+    pool->freeCells++;
+}
+
+/**
+ * Function that hands all empty cells of the pool to a lock-free stack, so that many threads
+ * can claim and release cells at once with claimSlot and releaseSlot. The pool stops growing,
+ * its capacity at this moment is the limit. Links and values of the lists must still be
+ * changed by one thread at a time, and insertRangeAfter and migration between pools fail
+ * until the slots are disabled
+ * @param list Pointer to list_t
+ * @return 0 if allocation error occures, 1 otherwise
+ */
+
+int enableConcurrentSlots(list_t *list) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (pool->slots)
+        return 1;
+
+    assert(pool->capacity < SLOT_INDEX_MASK);
+
+    slotAllocator_t *slots = new (std::nothrow) slotAllocator_t;
+    if (!slots)
+        return 0;
+
+    slots->link = new (std::nothrow) std::atomic<long long>[pool->capacity + 1];
+    if (!slots->link) {
+        delete slots;
+        return 0;
+    }
+
+    // Links of claimed cells may still be read by a pop that is going to fail, so they must hold a valid value
+    for (size_t i = 0; i <= pool->capacity; i++)
+        slots->link[i].store(-1, std::memory_order_relaxed);
+
+    for (long long node = pool->emptyHead; node != -1; node = listPrev(pool, node))
+        slots->link[node].store(listPrev(pool, node), std::memory_order_relaxed);
+
+    slots->capacity = pool->capacity;
+    slots->top.store(pool->emptyHead + 1, std::memory_order_release);
+
+    pool->slots = slots;
+    pool->emptyHead = -1;
+    pool->freeCells = 0;
+
+    return 1;
+}
+
+/**
+ * Function that moves empty cells from the lock-free stack back to emptyHead.
+ * No thread may use the slots at this moment and all magazines must be flushed
+ * @param list Pointer to list_t
+ */
+
+void disableConcurrentSlots(list_t *list) {
+    assert(list);
+
+    list_t *pool = list->pool;
+    slotAllocator_t *slots = pool->slots;
+
+    if (!slots)
+        return;
+
+    long long node = (long long) (slots->top.load(std::memory_order_acquire) & SLOT_INDEX_MASK) - 1;
+
+    pool->emptyHead = node;
+    pool->freeCells = 0;
+
+    while (node != -1) {
+        long long next = slots->link[node].load(std::memory_order_relaxed);
+
+        listPrev(pool, node) = next;
+        pool->freeCells++;
+        node = next;
+    }
+
+    delete[] slots->link;
+    delete slots;
+    pool->slots = nullptr;
+}
+
+/**
+ * Function that pushes chain of cells, already linked from first to last, on the stack
+ * @param slots Pointer to slotAllocator_t
+ * @param first Cell that becomes the top
+ * @param last Cell that gets linked to the previous top
+ */
+
+void pushSlots(slotAllocator_t *slots, long long first, long long last) {
+    unsigned long long top = slots->top.load(std::memory_order_relaxed);
+    unsigned long long newTop = 0;
+
+    do {
+        slots->link[last].store((long long) (top & SLOT_INDEX_MASK) - 1, std::memory_order_relaxed);
+        newTop = (((top >> SLOT_INDEX_BITS) + 1) << SLOT_INDEX_BITS) | (unsigned long long) (first + 1);
+    } while (!slots->top.compare_exchange_weak(top, newTop, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * Function that pops up to count cells from the stack by a single exchange. Cells below the top
+ * cannot change without the top changing, so the chain read before a successful exchange is valid
+ * @param slots Pointer to slotAllocator_t
+ * @param cells Array for popped cells
+ * @param count Maximal number of cells
+ * @return Number of popped cells, 0 if the stack is empty
+ */
+
+size_t popSlots(slotAllocator_t *slots, long long *cells, size_t count) {
+    unsigned long long top = slots->top.load(std::memory_order_acquire);
+
+    while (true) {
+        long long node = (long long) (top & SLOT_INDEX_MASK) - 1;
+        size_t popped = 0;
+
+        while (node != -1 && popped < count) {
+            cells[popped++] = node;
+            node = slots->link[node].load(std::memory_order_relaxed);
+        }
+
+        if (popped == 0)
+            return 0;
+
+        unsigned long long newTop = (((top >> SLOT_INDEX_BITS) + 1) << SLOT_INDEX_BITS) |
+                                    (unsigned long long) (node + 1);
+
+        if (slots->top.compare_exchange_weak(top, newTop, std::memory_order_acquire, std::memory_order_acquire))
+            return popped;
+    }
+}
+
+/**
+ * Function that claims an empty cell from any thread. The cell belongs to nobody until
+ * the owner of the list links it or it is released. With a magazine the shared stack is
+ * touched once per SLOT_MAGAZINE_SIZE / 2 claims
+ * @param list Pointer to list_t with concurrent slots enabled
+ * @param magazine Pointer to magazine of the calling thread or nullptr
+ * @return Physical number of cell, -1 if there are no empty cells
+ */
+
+long long claimSlot(list_t *list, slotMagazine_t *magazine) {
+    assert(list && list->pool->slots);
+
+    slotAllocator_t *slots = list->pool->slots;
+    long long cell = -1;
+
+    if (!magazine)
+        return popSlots(slots, &cell, 1) ? cell : -1;
+
+    if (magazine->count == 0)
+        magazine->count = popSlots(slots, magazine->slots, SLOT_MAGAZINE_SIZE / 2);
+
+    return magazine->count ? magazine->slots[--magazine->count] : -1;
+}
+
+/**
+ * Function that returns claimed cell from any thread. A full magazine gives half of its cells
+ * back to the shared stack by a single exchange
+ * @param list Pointer to list_t with concurrent slots enabled
+ * @param node Physical number of cell
+ * @param magazine Pointer to magazine of the calling thread or nullptr
+ */
+
+void releaseSlot(list_t *list, long long node, slotMagazine_t *magazine) {
+    assert(list && list->pool->slots);
+
+    slotAllocator_t *slots = list->pool->slots;
+
+    assert(node >= 0 && node < (long long) slots->capacity);
+
+    if (!magazine) {
+        pushSlots(slots, node, node);
+        return;
+    }
+
+    if (magazine->count == SLOT_MAGAZINE_SIZE) {
+        size_t half = SLOT_MAGAZINE_SIZE / 2;
+        long long *chain = magazine->slots + SLOT_MAGAZINE_SIZE - half;
+
+        for (size_t i = 0; i + 1 < half; i++)
+            slots->link[chain[i]].store(chain[i + 1], std::memory_order_relaxed);
+
+        pushSlots(slots, chain[0], chain[half - 1]);
+        magazine->count -= half;
+    }
+
+    magazine->slots[magazine->count++] = node;
+}
+
+/**
+ * Function that returns all cells of the magazine to the shared stack
+ * @param list Pointer to list_t with concurrent slots enabled
+ * @param magazine Pointer to magazine
+ */
+
+void flushMagazine(list_t *list, slotMagazine_t *magazine) {
+    assert(list && list->pool->slots);
+    assert(magazine);
+
+    if (magazine->count == 0)
+        return;
+
+    slotAllocator_t *slots = list->pool->slots;
+
+    for (size_t i = 0; i + 1 < magazine->count; i++)
+        slots->link[magazine->slots[i]].store(magazine->slots[i + 1], std::memory_order_relaxed);
+
+    pushSlots(slots, magazine->slots[0], magazine->slots[magazine->count - 1]);
+    magazine->count = 0;
+}
+
+/**
+ * Function that turns the list into a multi-producer single-consumer queue over the same cells.
+ * Nodes of the list stay queued in their order. Concurrent slots are enabled, producers take
+ * cells with claimSlot and the consumer returns them with releaseSlot. List must own its cells
+ * and must not share them. Until disableQueueMode only enqueue and dequeue may be used,
+ * head, tail and size of the list are not maintained
+ * @param list Pointer to list_t
+ * @return 0 if allocation error occures or there is no cell for the dummy node, 1 otherwise
+ */
+
+int enableQueueMode(list_t *list) {
+    assert(list);
+    assert(list->pool == list && list->sharers == 0);
+
+    if (list->queue)
+        return 1;
+
+    mpscQueue_t *queue = new (std::nothrow) mpscQueue_t;
+    if (!queue)
+        return 0;
+
+    if (list->freeCells == 0)
+        growList(list);
+
+    queue->next = new (std::nothrow) std::atomic<long long>[list->capacity + 1];
+    if (!queue->next || list->freeCells == 0 || !enableConcurrentSlots(list)) {
+        delete[] queue->next;
+        delete queue;
+        return 0;
+    }
+
+    long long dummy = claimSlot(list);
+
+    queue->head = dummy;
+    queue->next[dummy].store(list->head, std::memory_order_relaxed);
+
+    for (long long node = list->head; node != -1; node = listNext(list, node))
+        queue->next[node].store(listNext(list, node), std::memory_order_relaxed);
+
+    queue->tail.store(list->tail == -1 ? dummy : list->tail, std::memory_order_release);
+
+    resetOccupancy(list, 0);
+    list->queue = queue;
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+    list->linearPrefix = 0;
+    invalidateJumpIndex(list);
+
+    return 1;
+}
+
+/**
+ * Function that turns the queue back into an ordinary list of the nodes that are still queued
+ * and disables concurrent slots. No thread may enqueue or dequeue at this moment and all
+ * magazines must be flushed
+ * @param list Pointer to list_t
+ */
+
+void disableQueueMode(list_t *list) {
+    assert(list);
+
+    mpscQueue_t *queue = list->queue;
+
+    if (!queue)
+        return;
+
+    long long prev = -1;
+
+    for (long long node = queue->next[queue->head].load(std::memory_order_acquire); node != -1;
+         node = queue->next[node].load(std::memory_order_acquire)) {
+        listPrev(list, node) = prev;
+        listNext(list, node) = -1;
+        if (prev != -1)
+            listNext(list, prev) = node;
+        else
+            list->head = node;
+
+        markOccupied(list, node, true);
+        list->size++;
+        prev = node;
+    }
+
+    list->tail = prev;
+    releaseSlot(list, queue->head);
+    list->queue = nullptr;
+
+    delete[] queue->next;
+    delete queue;
+
+    disableConcurrentSlots(list);
+}
+
+/**
+ * Function that adds value to the tail of the queue from any thread.
+ * The cell is published by one atomic exchange of the tail and one store to the old tail
+ * @param list Pointer to list_t in queue mode
+ * @param value Value
+ * @param magazine Pointer to magazine of the calling thread or nullptr
+ * @return 0 if there are no empty cells, 1 otherwise
+ */
+
+int enqueue(list_t *list, void *value, slotMagazine_t *magazine) {
+    assert(list && list->queue);
+
+    mpscQueue_t *queue = list->queue;
+    long long node = claimSlot(list, magazine);
+
+    if (node == -1)
+        return 0;
+
+    listValue(list, node) = value;
+    queue->next[node].store(-1, std::memory_order_relaxed);
+
+    long long prev = queue->tail.exchange(node, std::memory_order_acq_rel);
+    queue->next[prev].store(node, std::memory_order_release);
+
+    return 1;
+}
+
+/**
+ * Function that takes value from the head of the queue. Must be called by one thread only.
+ * The head cell is a dummy, the first value lives in the next cell which becomes the new dummy,
+ * so taking a value is one load and never waits for producers
+ * @param list Pointer to list_t in queue mode
+ * @param value Pointer to place for the value
+ * @param magazine Pointer to magazine of the consumer or nullptr
+ * @return 0 if the queue is empty or its first value is not published yet, 1 otherwise
+ */
+
+int dequeue(list_t *list, void **value, slotMagazine_t *magazine) {
+    assert(list && list->queue);
+    assert(value);
+
+    mpscQueue_t *queue = list->queue;
+    long long dummy = queue->head;
+    long long node = queue->next[dummy].load(std::memory_order_acquire);
+
+    if (node == -1)
+        return 0;
+
+    *value = listValue(list, node);
+    listValue(list, dummy) = nullptr;
+    clearNodeKey(list, dummy);
+    queue->head = node;
+    releaseSlot(list, dummy, magazine);
+
+    return 1;
+}
+
+/**
+ * Function that turns list with fixed maxsize into a single-producer single-consumer ring over
+ * cells [0, maxsize). Nodes of the list are linearized and stay in the ring in their order.
+ * Links are set circular once, so pushing and popping only write values and move two counters.
+ * Until disableRingMode only ringPush, ringPop, ringSize and the inspection functions
+ * getFirstElement, getLastElement, getNextElement and getPreviousElement may be used.
+ * List must own its cells and must not share them
+ * @param list Pointer to list_t
+ * @return 0 if list is unbounded or allocation error occures, 1 otherwise
+ */
+
+int enableRingMode(list_t *list) {
+    assert(list);
+    assert(list->pool == list && list->sharers == 0 && !list->slots);
+
+    if (list->ring)
+        return 1;
+
+    if (list->maxsize == LIST_UNBOUNDED)
+        return 0;
+
+    while (list->capacity < list->maxsize) {
+        if (!growList(list))
+            return 0;
+    }
+
+    spscRing_t *ring = new (std::nothrow) spscRing_t;
+    if (!ring)
+        return 0;
+
+    sortList(list);
+
+    long long capacity = list->capacity;
+
+    for (long long i = 0; i < capacity; i++) {
+        listNext(list, i) = (i + 1) % capacity;
+        listPrev(list, i) = (i + capacity - 1) % capacity;
+    }
+
+    ring->capacity = capacity;
+    ring->tail.store(list->size, std::memory_order_relaxed);
+    ring->cachedHead = 0;
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->cachedTail = list->size;
+
+    resetOccupancy(list, 0);
+    list->ring = ring;
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+    list->emptyHead = -1;
+    list->freeCells = 0;
+    list->linearPrefix = 0;
+    invalidateJumpIndex(list);
+
+    return 1;
+}
+
+/**
+ * Function that turns the ring back into an ordinary linearized list of the values that are
+ * still in the ring. Neither producer nor consumer may use the ring at this moment
+ * @param list Pointer to list_t
+ */
+
+void disableRingMode(list_t *list) {
+    assert(list);
+
+    spscRing_t *ring = list->ring;
+
+    if (!ring)
+        return;
+
+    size_t head = ring->head.load(std::memory_order_acquire);
+    size_t size = ring->tail.load(std::memory_order_acquire) - head;
+
+    list->ring = nullptr;
+    delete ring;
+
+    list->head = size ? (long long) (head % list->capacity) : -1;
+    list->tail = size ? (long long) ((head + size - 1) % list->capacity) : -1;
+    list->size = size;
+    sortList(list);
+}
+
+/**
+ * Function that returns number of values in the ring
+ * @param list Pointer to list_t in ring mode
+ * @return Number of values
+ */
+
+size_t ringSize(list_t *list) {
+    assert(list && list->ring);
+
+    spscRing_t *ring = list->ring;
+
+    return ring->tail.load(std::memory_order_acquire) - ring->head.load(std::memory_order_acquire);
+}
+
+/**
+ * Function that appends up to n values to the ring and publishes them by one store.
+ * Must be called by the producer only. The consumer position is reloaded only when
+ * the cached one says the ring is full
+ * @param list Pointer to list_t in ring mode
+ * @param values Values
+ * @param n Number of values
+ * @return Number of pushed values
+ */
+
+size_t ringPush(list_t *list, void *const *values, size_t n) {
+    assert(list && list->ring);
+    assert(values || n == 0);
+
+    spscRing_t *ring = list->ring;
+    size_t tail = ring->tail.load(std::memory_order_relaxed);
+
+    if (tail + n - ring->cachedHead > ring->capacity)
+        ring->cachedHead = ring->head.load(std::memory_order_acquire);
+
+    n = std::min(n, ring->capacity - (tail - ring->cachedHead));
+
+    for (size_t i = 0, cell = tail % ring->capacity; i < n; i++, cell = (cell + 1 < ring->capacity) ? cell + 1 : 0)
+        listValue(list, cell) = values[i];
+
+    ring->tail.store(tail + n, std::memory_order_release);
+
+    return n;
+}
+
+/**
+ * Function that takes up to n values from the ring and frees their cells by one store.
+ * Must be called by the consumer only. The producer position is reloaded only when
+ * the cached one says the ring is empty
+ * @param list Pointer to list_t in ring mode
+ * @param values Place for values
+ * @param n Maximal number of values
+ * @return Number of taken values
+ */
+
+size_t ringPop(list_t *list, void **values, size_t n) {
+    assert(list && list->ring);
+    assert(values || n == 0);
+
+    spscRing_t *ring = list->ring;
+    size_t head = ring->head.load(std::memory_order_relaxed);
+
+    if (ring->cachedTail - head < n)
+        ring->cachedTail = ring->tail.load(std::memory_order_acquire);
+
+    n = std::min(n, ring->cachedTail - head);
+
+    for (size_t i = 0, cell = head % ring->capacity; i < n; i++, cell = (cell + 1 < ring->capacity) ? cell + 1 : 0)
+        values[i] = listValue(list, cell);
+
+    ring->head.store(head + n, std::memory_order_release);
+
+    return n;
+}
+
+/**
+ * Function that invalidates linearized prefix starting from the given position.
+ * Cell with physical number below linearPrefix has the same logical position,
+ * so physical number of a changed element can be passed as well
+ * @param list Pointer to list_t
+ * @param bound First logical position that is no longer in order
+ */
+
+void shrinkLinearPrefix(list_t *list, long long bound) {
+    assert(list);
+
+    if (bound < (long long) list->linearPrefix)
+        list->linearPrefix = bound;
+}
+
+/**
+ * Function that extends linearized prefix if the new element was placed right after it
+ * @param list Pointer to list_t
+ * @param newNode Physical number of inserted element
+ */
+
+void extendLinearPrefix(list_t *list, long long newNode) {
+    assert(list);
+
+    if (list->linearPrefix + 1 == list->size && newNode == list->tail && newNode == (long long) list->linearPrefix)
+        list->linearPrefix++;
+}
+
+/**
+ * Function that enables index of every stride-th logical position.
+ * Index is built lazily by the first positional lookup
+ * @param list Pointer to list_t
+ * @param stride Distance between anchors, 0 to use square root of list size
+ */
+
+void enableJumpIndex(list_t *list, size_t stride) {
+    assert(list);
+
+    if (!list->jump)
+        list->jump = (jumpIndex_t *) calloc(1, sizeof(jumpIndex_t));
+
+    list->jump->stride = stride;
+    list->jump->autoStride = (stride == 0);
+    list->jump->valid = false;
+}
+
+/**
+ * Function that disables jump index and frees its memory
+ * @param list Pointer to list_t
+ */
+
+void disableJumpIndex(list_t *list) {
+    assert(list);
+
+    if (!list->jump)
+        return;
+
+    free(list->jump->anchors);
+    free(list->jump->positions);
+    free(list->jump->anchorBits);
+    free(list->jump);
+    list->jump = nullptr;
+}
+
+/**
+ * Function that rebuilds jump index by one walk over the list
+ * @param list Pointer to list_t
+ */
+
+void rebuildJumpIndex(list_t *list) {
+    assert(list);
+    assert(list->jump);
+
+    jumpIndex_t *jump = list->jump;
+
+    if (jump->autoStride) {
+        jump->stride = 1;
+        while (jump->stride * jump->stride < list->size)
+            jump->stride++;
+    }
+
+    size_t count = (list->size + jump->stride - 1) / jump->stride;
+
+    if (count > jump->allocated) {
+        free(jump->anchors);
+        free(jump->positions);
+        jump->anchors = (long long *) calloc(count, sizeof(long long));
+        jump->positions = (size_t *) calloc(count, sizeof(size_t));
+        jump->allocated = count;
+    }
+
+    if (jump->bitCells < list->pool->capacity) {
+        free(jump->anchorBits);
+        jump->bitCells = list->pool->capacity;
+        jump->anchorBits = (unsigned long long *) calloc((jump->bitCells + 63) / 64, sizeof(unsigned long long));
+    } else {
+        memset(jump->anchorBits, 0, (jump->bitCells + 63) / 64 * sizeof(unsigned long long));
+    }
+
+    jump->count = 0;
+    long long node = list->head;
+
+    for (size_t pos = 0; pos < list->size; pos++) {
+        if (pos % jump->stride == 0) {
+            jump->anchors[jump->count] = node;
+            jump->positions[jump->count] = pos;
+            jump->anchorBits[node / 64] |= 1ull << (node % 64);
+            jump->count++;
+        }
+
+        node = listNext(list, node);
+    }
+
+    jump->valid = true;
+    jump->rebuilds++;
+}
+
+/**
+ * Function that checks if the cell is an anchor of jump index
+ * @param jump Pointer to jumpIndex_t
+ * @param node Physical number of cell
+ * @return True if cell is an anchor
+ */
+
+bool isJumpAnchor(jumpIndex_t *jump, long long node) {
+    return (size_t) node < jump->bitCells && (jump->anchorBits[node / 64] >> (node % 64) & 1);
+}
+
+/**
+ * Function that walks back from the node to the closest anchor
+ * @param list Pointer to list_t
+ * @param node Physical number of element, it is not checked itself
+ * @param anchor Where to save physical number of anchor, -1 if head was reached
+ * @return False if anchors are further than they should be, true otherwise
+ */
+
+bool findJumpAnchor(list_t *list, long long node, long long *anchor) {
+    assert(list);
+    assert(list->jump);
+    assert(anchor);
+
+    size_t steps = 0;
+    node = listPrev(list, node);
+
+    while (node != -1 && !isJumpAnchor(list->jump, node)) {
+        if (++steps > 2 * list->jump->stride)
+            return false;
+
+        node = listPrev(list, node);
+    }
+
+    *anchor = node;
+    return true;
+}
+
+/**
+ * Function that marks jump index for rebuild on the next lookup
+ * @param list Pointer to list_t
+ */
+
+void invalidateJumpIndex(list_t *list) {
+    assert(list);
+
+    if (list->jump)
+        list->jump->valid = false;
+}
+
+/**
+ * Function that patches logical positions of anchors after insertion of the element
+ * @param list Pointer to list_t
+ * @param newNode Physical number of inserted element, already linked into list
+ */
+
+void patchJumpIndexInsert(list_t *list, long long newNode) {
+    assert(list);
+
+    jumpIndex_t *jump = list->jump;
+
+    if (!jump || !jump->valid)
+        return;
+
+    long long anchor = -1;
+
+    if (!findJumpAnchor(list, newNode, &anchor)) {
+        jump->valid = false;
+        return;
+    }
+
+    size_t entry = jump->count;
+
+    while (entry > 0 && jump->anchors[entry - 1] != anchor) {
+        jump->positions[entry - 1]++;
+        entry--;
+    }
+
+    if (entry < jump->count) {
+        size_t gapStart = entry > 0 ? jump->positions[entry - 1] : 0;
+
+        if (jump->positions[entry] - gapStart > 2 * jump->stride)
+            jump->valid = false;
+    }
+}
+
+/**
+ * Function that patches logical positions of anchors before deletion of the element
+ * @param list Pointer to list_t
+ * @param node Physical number of element that is going to be deleted
+ */
+
+void patchJumpIndexDelete(list_t *list, long long node) {
+    assert(list);
+
+    jumpIndex_t *jump = list->jump;
+
+    if (!jump || !jump->valid)
+        return;
+
+    long long anchor = -1;
+
+    if (isJumpAnchor(jump, node) || !findJumpAnchor(list, node, &anchor)) {
+        jump->valid = false;
+        return;
+    }
+
+    size_t entry = jump->count;
+
+    while (entry > 0 && jump->anchors[entry - 1] != anchor) {
+        jump->positions[entry - 1]--;
+        entry--;
+    }
+}
+
+/**
+ * Function that adds value to the tail of the list
+ * @param list Pointer to list_t
+ * @param value Void pointer to value
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int addToTail(list_t *list, void *value) {
+    assert(list);
+
+    if (list->size == list->maxsize)
+        return 0;
+
+    long long temp = list->tail;
+    long long newNode = getEmpty(list);
+
+    if (newNode == -1)
+        return 0;
+
+    listValue(list, newNode) = value;
+    listPrev(list, newNode) = temp;
+    listNext(list, newNode) = -1;
+
+    if (temp != -1) {
+        listNext(list, temp) = newNode;
+    }
+
+    list->tail = newNode;
+
+    if (list->head == -1) {
+        list->head = newNode;
+    }
+
+    list->size++;
+    extendLinearPrefix(list, newNode);
+    patchJumpIndexInsert(list, newNode);
+
+    return 1;
+}
+
+/**
+ * Function that inserts element after the given one
+ * @param list Pointer to list_t
+ * @param elem Physical number of element
+ * @param value Void pointer to value
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int insertAfter(list_t *list, long long elem, void *value) {
+    assert(list);
+    assert(elem >= 0);
+
+    if (list->size == list->maxsize)
+        return 0;
+
+    long long tmp = listNext(list, elem);
+    long long newNode = getEmpty(list);
+
+    if (newNode == -1)
+        return 0;
+
+    listPrev(list, newNode) = elem;
+    listNext(list, newNode) = tmp;
+    listValue(list, newNode) = value;
+
+    listNext(list, elem) = newNode;
+
+    if (tmp != -1) {
+        listPrev(list, tmp) = newNode;
+    } else {
+        list->tail = newNode;
+    }
+
+    list->size++;
+    shrinkLinearPrefix(list, elem + 1);
+    extendLinearPrefix(list, newNode);
+    patchJumpIndexInsert(list, newNode);
+
+    return 1;
+}
+
+/**
+ * Function that inserts element before the given one
+ * @param list Pointer to list_t
+ * @param elem Physical number of element
+ * @param value Void pointer to value
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int insertBefore(list_t *list, long long elem, void *value) {
+    assert(list);
+    assert(elem >= 0);
+
+    if (list->size == list->maxsize)
+        return 0;
+
+    long long tmp = listPrev(list, elem);
+    long long newNode = getEmpty(list);
+
+    if (newNode == -1)
+        return 0;
+
+    listNext(list, newNode) = elem;
+    listPrev(list, newNode) = tmp;
+    listValue(list, newNode) = value;
+
+    listPrev(list, elem) = newNode;
+
+    if (tmp != -1) {
+        listNext(list, tmp) = newNode;
+    } else {
+        list->head = newNode;
+    }
+
+    list->size++;
+    shrinkLinearPrefix(list, elem);
+    patchJumpIndexInsert(list, newNode);
+
+    return 1;
+}
+
+/**
+ * Function that inserts several values after the given element in one pass.
+ * Cells are taken from the list of the empty cells in runs, so a block inserted into
+ * a fresh or sorted list is placed in consecutive cells and its values are stored at once
+ * @param list Pointer to list_t
+ * @param elem Physical number of element, -1 to insert before head
+ * @param values Array of void pointers to values
+ * @param n Number of values
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int insertRangeAfter(list_t *list, long long elem, void **values, size_t n) {
+    assert(list);
+    assert(values || n == 0);
+
+    if (n == 0)
+        return 1;
+
+    if (list->maxsize - list->size < n)
+        return 0;
+
+    list_t *pool = list->pool;
+
+    while (pool->freeCells < n) {
+        if (!growList(pool))
+            return 0;
+    }
+
+    size_t oldSize = list->size;
+    long long after = (elem == -1) ? list->head : listNext(list, elem);
+    long long last = elem;
+    long long first = pool->emptyHead;
+    bool consecutive = true;
+
+    for (size_t i = 0; i < n;) {
+        long long start = pool->emptyHead;
+        size_t run = 1;
+
+        while (i + run < n && ((start + run) & LIST_CHUNK_MASK) != 0 &&
+               listPrev(list, start + run - 1) == start + (long long) run)
+            run++;
+
+        pool->emptyHead = listPrev(list, start + run - 1);
+
+        storeCellValues(pool, start, values + i, run);
+
+        for (size_t k = 0; k < run; k++) {
+            listNext(list, start + k) = start + k + 1;
+            listPrev(list, start + k) = start + k - 1;
+            markOccupied(list, start + k, true);
+        }
+
+        if (last != -1 && last + 1 != start)
+            consecutive = false;
+
+        listPrev(list, start) = last;
+        if (last != -1)
+            listNext(list, last) = start;
+        else
+            list->head = start;
+
+        last = start + run - 1;
+        i += run;
+    }
+
+    listNext(list, last) = after;
+    if (after != -1)
+        listPrev(list, after) = last;
+    else
+        list->tail = last;
+
+    list->size += n;
+    pool->freeCells -= n;
+    shrinkLinearPrefix(list, elem + 1);
+
+    if (after == -1 && consecutive && list->linearPrefix == oldSize && first == (long long) oldSize)
+        list->linearPrefix = list->size;
+
+    invalidateJumpIndex(list);
+
+    return 1;
+}
+
+/**
+ * Function that adds several values to the tail of the list in one pass
+ * @param list Pointer to list_t
+ * @param values Array of void pointers to values
+ * @param n Number of values
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int appendRange(list_t *list, void **values, size_t n) {
+    assert(list);
+
+    return insertRangeAfter(list, list->tail, values, n);
+}
+
+/**
+ * Function that gets the first element of the list
+ * @param list Poiter to list_t
+ * @return Physical number of element
+ */
+
+long long getFirstElement(list_t *list) {
+    assert(list);
+
+    if (list->ring) {
+        size_t head = list->ring->head.load(std::memory_order_acquire);
+        return (list->ring->tail.load(std::memory_order_acquire) != head) ? (long long) (head % list->ring->capacity)
+                                                                          : -1;
+    }
+
+    return list->head;
+}
+
+/**
+ * Function that gets the last element of the list
+ * @param list Poiter to list_t
+ * @return Physical number of element
+ */
+
+long long getLastElement(list_t *list) {
+    assert(list);
+
+    if (list->ring) {
+        size_t tail = list->ring->tail.load(std::memory_order_acquire);
+        return (list->ring->head.load(std::memory_order_acquire) != tail) ? (long long) ((tail - 1) %
+                                                                                         list->ring->capacity) : -1;
+    }
+
+    return list->tail;
+}
+
+/**
+ * Function that gets element after the given one
+ * @param list Poiter to list_t
+ * @param node Physical adress of element
+ * @return Physical number of element
+ */
+
+long long getNextElement(list_t *list, long long node) {
+    assert(list);
+    assert(node >= 0);
+
+    if (list->ring && node == getLastElement(list))
+        return -1;
+
+    return listNext(list, node);
+}
+
+/**
+ * Function that gets element before the given one
+ * @param list Pointer to list_t
+ * @param node Physical address of element
+ * @return Physical number of element
+ */
+
+long long getPreviousElement(list_t *list, long long node) {
+    assert(list);
+    assert(node >= 0);
+
+    if (list->ring && node == getFirstElement(list))
+        return -1;
+
+    return listPrev(list, node);
+}
+
+/**
+ * Function that returns physical address by logical adress.
+ * Positions inside the linearized prefix are resolved without walking the list,
+ * other positions are walked from the closest anchor of the jump index if it is enabled
+ * @param list Pointer to list_t
+ * @param position Logical position
+ * @return Physical position
+ */
+
+long long getElementByPosition(list_t *list, size_t position) {
+    assert(list);
+
+    if (position >= list->size)
+        return -1;
+
+    if (position < list->linearPrefix)
+        return position;
+
+    long long curNode = list->head;
+    size_t i = 0;
+
+    if (list->linearPrefix > 0) {
+        curNode = list->linearPrefix - 1;
+        i = list->linearPrefix - 1;
+    }
+
+    jumpIndex_t *jump = list->jump;
+
+    if (jump) {
+        if (!jump->valid)
+            rebuildJumpIndex(list);
+
+        size_t left = 0;
+        size_t right = jump->count;
+
+        while (left < right) {
+            size_t middle = (left + right) / 2;
+
+            if (jump->positions[middle] <= position)
+                left = middle + 1;
+            else
+                right = middle;
+        }
+
+        if (left > 0 && jump->positions[left - 1] > i) {
+            curNode = jump->anchors[left - 1];
+            i = jump->positions[left - 1];
+            jump->hits++;
+        }
+    }
+
+    for (; i < position; i++) {
+        if (curNode == -1)
+            return curNode;
+        curNode = listNext(list, curNode);
+    }
+
+    return curNode;
+}
+
+/**
+ * Function that finds first occurance of the value
+ * @param list Pointer to list_t
+ * @param value Void to pointer value
+ * @param cmp Pointer to comparator
+ * @return Physical address of the element
+ */
+
+long long findFirstNode(list_t *list, void *value, bool (*cmp)(void *, void *)) {
+    assert(list);
+
+    long long node = list->head;
+
+    for (size_t i = 0; i < list->size; i++) {
+        if (node == -1)
+            return -1;
+
+        if (cmp(listValue(list, node), value))
+            return node;
+
+        node = listNext(list, node);
+    }
+
+    return -1;
+}
+
+/**
+ * Function that finds last occurance of the value
+ * @param list Pointer to list_t
+ * @param value Void to pointer value
+ * @param cmp Pointer to comparator
+ * @return Physical address of the element
+ */
+
+long long findLastNode(list_t *list, void *value, bool (*cmp)(void *, void *)) {
+    assert(list);
+
+    long long node = list->tail;
+
+    for (size_t i = 0; i < list->size; i++) {
+        if (node == -1)
+            return -1;
+
+        if (cmp(listValue(list, node), value))
+            return node;
+
+        node = listPrev(list, node);
+    }
+
+    return -1;
+}
+
+/**
+ * Function that allocates key chunk of the pool. Key chunks always have LIST_CHUNK_SIZE cells,
+ * the tail beyond capacity is never keyed, so scans need no remainder loop
+ * @param pool Pointer to list_t that owns cells
+ * @param chunk Number of chunk
+ * @return 0 if allocation error occures, 1 otherwise
+ */
+
+int allocateKeyChunk(list_t *pool, size_t chunk) {
+    long long *keys = (long long *) calloc(LIST_CHUNK_SIZE, sizeof(long long));
+    unsigned long long *keyed = (unsigned long long *) calloc(LIST_CHUNK_SIZE / 64, sizeof(unsigned long long));
+
+    if (!keys || !keyed) {
+        free(keys);
+        free(keyed);
+        return 0;
+    }
+
+    pool->keys[chunk] = keys;
+    pool->keyed[chunk] = keyed;
+
+    return 1;
+}
+
+/**
+ * Function that returns number of words in the bitmap of key matches
+ * @param directorySize Number of chunks the directories can hold
+ * @return Number of unsigned long long words
+ */
+
+size_t keyMatchWords(size_t directorySize) {
+    return directorySize * (LIST_CHUNK_SIZE / 64) + 1;
+}
+
+/**
+ * Function that enables inline integer keys for all cells of the pool of the list.
+ * Keys are kept in their own arrays beside the links, so findFirstKey and findLastKey
+ * compare them several at a time without dereferencing values. Scans reuse the bitmap of
+ * matches of the pool, so key lookups in lists of one pool must not run at the same time
+ * @param list Pointer to list_t
+ * @return 0 if allocation error occures, 1 otherwise
+ */
+
+int enableKeys(list_t *list) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (pool->keys)
+        return 1;
+
+    size_t directorySize = pool->directorySize ? pool->directorySize : 1;
+    long long **keys = (long long **) calloc(directorySize, sizeof(long long *));
+    unsigned long long **keyed = (unsigned long long **) calloc(directorySize, sizeof(unsigned long long *));
+    unsigned long long *keyMatches = (unsigned long long *) calloc(keyMatchWords(directorySize),
+                                                                   sizeof(unsigned long long));
+
+    if (!keys || !keyed || !keyMatches) {
+        free(keys);
+        free(keyed);
+        free(keyMatches);
+        return 0;
+    }
+
+    pool->keys = keys;
+    pool->keyed = keyed;
+    pool->keyMatches = keyMatches;
+
+    for (size_t i = 0; i < pool->chunks; i++) {
+        if (allocateKeyChunk(pool, i))
+            continue;
+
+        for (size_t j = 0; j < i; j++) {
+            free(keys[j]);
+            free(keyed[j]);
+        }
+
+        free(keys);
+        free(keyed);
+        free(keyMatches);
+        pool->keys = nullptr;
+        pool->keyed = nullptr;
+        pool->keyMatches = nullptr;
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Function that sets inline key of the cell. Keys must be enabled
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @param key Key
+ */
+
+void setNodeKey(list_t *list, long long node, long long key) {
+    assert(list && list->pool->keys);
+    assert(node >= 0 && node < (long long) list->pool->capacity);
+
+    list_t *pool = list->pool;
+
+    pool->keys[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK] = key;
+    pool->keyed[node >> LIST_CHUNK_SHIFT][(node & LIST_CHUNK_MASK) / 64] |= 1ull << (node % 64);
+}
+
+/**
+ * Function that checks whether the cell has inline key
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @return True if key was set, False otherwise or if keys are not enabled
+ */
+
+bool hasNodeKey(list_t *list, long long node) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (!pool->keys)
+        return false;
+
+    return (pool->keyed[node >> LIST_CHUNK_SHIFT][(node & LIST_CHUNK_MASK) / 64] >> (node % 64)) & 1;
+}
+
+/**
+ * Function that returns inline key of the cell
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @return Key, the cell must have one
+ */
+
+long long getNodeKey(list_t *list, long long node) {
+    assert(hasNodeKey(list, node));
+
+    return list->pool->keys[node >> LIST_CHUNK_SHIFT][node & LIST_CHUNK_MASK];
+}
+
+/**
+ * Function that removes inline key of the cell, does nothing if keys are not enabled
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ */
+
+void clearNodeKey(list_t *list, long long node) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (!pool->keys)
+        return;
+
+    pool->keyed[node >> LIST_CHUNK_SHIFT][(node & LIST_CHUNK_MASK) / 64] &= ~(1ull << (node % 64));
+}
+
+/**
+ * Function that compares 64 consecutive keys with the given one. Uses AVX2 or SSE4.1
+ * when the compiler targets them and plain comparisons otherwise
+ * @param keys Pointer to 64 keys
+ * @param keyed Bitmap of cells which have keys
+ * @param key Key to look for
+ * @return Bitmap of keyed cells whose key is equal to the given one
+ */
+
+unsigned long long matchKeys(const long long *keys, unsigned long long keyed, long long key) {
+    unsigned long long match = 0;
+
+#if defined(__AVX2__)
+    __m256i pattern = _mm256_set1_epi64x(key);
+
+    for (unsigned i = 0; i < 64; i += 4) {
+        __m256i equal = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) (keys + i)), pattern);
+        match |= (unsigned long long) _mm256_movemask_pd(_mm256_castsi256_pd(equal)) << i;
+    }
+#elif defined(__SSE4_1__)
+    __m128i pattern = _mm_set1_epi64x(key);
+
+    for (unsigned i = 0; i < 64; i += 2) {
+        __m128i equal = _mm_cmpeq_epi64(_mm_loadu_si128((const __m128i *) (keys + i)), pattern);
+        match |= (unsigned long long) _mm_movemask_pd(_mm_castsi128_pd(equal)) << i;
+    }
+#else
+    for (unsigned i = 0; i < 64; i++)
+        match |= (unsigned long long) (keys[i] == key) << i;
+#endif
+
+    return match & keyed;
+}
+
+/**
+ * Function that marks every cell of the pool whose key is equal to the given one
+ * @param pool Pointer to list_t that owns cells
+ * @param key Key to look for
+ * @param matches Bitmap of capacity rounded up to LIST_CHUNK_SIZE bits, every word of it is
+ * overwritten, so it needs no clearing
+ * @return Number of matching cells
+ */
+
+size_t scanKeys(list_t *pool, long long key, unsigned long long *matches) {
+    size_t found = 0;
+
+    for (size_t chunk = 0; chunk < pool->chunks; chunk++) {
+        const long long *keys = pool->keys[chunk];
+        const unsigned long long *keyed = pool->keyed[chunk];
+
+        for (size_t word = 0; word < LIST_CHUNK_SIZE / 64; word++) {
+            unsigned long long match = keyed[word] ? matchKeys(keys + word * 64, keyed[word], key) : 0;
+
+            matches[chunk * (LIST_CHUNK_SIZE / 64) + word] = match;
+            found += __builtin_popcountll(match);
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Function that finds which of the matching cells comes first or last in the list without
+ * walking from the head or the tail. Every candidate steps towards the end of the list at
+ * the same pace: the candidate that meets another matching cell is not the answer, the one
+ * that runs off the end first is. Works only if every marked cell belongs to the list
+ * @param list Pointer to list_t
+ * @param matches Bitmap of matching cells
+ * @param found Number of matching cells, at most KEY_ORDER_CANDIDATES
+ * @param last Look for the last match instead of the first one
+ * @return Physical address of the element
+ */
+
+long long resolveKeyOrder(list_t *list, const unsigned long long *matches, size_t found, bool last) {
+    assert(found > 0 && found <= KEY_ORDER_CANDIDATES);
+
+    long long candidates[KEY_ORDER_CANDIDATES] = {};
+    long long cursors[KEY_ORDER_CANDIDATES] = {};
+    size_t alive = 0;
+
+    for (size_t word = 0; alive < found; word++) {
+        for (unsigned long long match = matches[word]; match; match &= match - 1) {
+            candidates[alive] = (long long) (word * 64 + __builtin_ctzll(match));
+            cursors[alive] = candidates[alive];
+            alive++;
+        }
+    }
+
+    while (alive > 1) {
+        for (size_t i = 0; i < alive;) {
+            long long step = last ? listNext(list, cursors[i]) : listPrev(list, cursors[i]);
+
+            if (step == -1)
+                return candidates[i];
+
+            if ((matches[step / 64] >> (step % 64)) & 1) {
+                alive--;
+                candidates[i] = candidates[alive];
+                cursors[i] = cursors[alive];
+                continue;
+            }
+
+            cursors[i] = step;
+            i++;
+        }
+    }
+
+    return candidates[0];
+}
+
+/**
+ * Function that finds first node of the list with the given inline key.
+ * The whole pool is scanned by SIMD comparisons into the bitmap of matches of the pool. If the answer is not in the linear prefix, the
+ * order is resolved among the matches only, unless the pool is shared or there are too many
+ * matches, then links are followed from the head until the first match
+ * @param list Pointer to list_t
+ * @param key Key to look for
+ * @return Physical address of the element, -1 if there is no such element or keys are not enabled
+ */
+
+long long findFirstKey(list_t *list, long long key) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (!pool->keys || list->size == 0)
+        return -1;
+
+    unsigned long long *matches = pool->keyMatches;
+    size_t found = scanKeys(pool, key, matches);
+    long long result = -1;
+
+    for (size_t word = 0; found && word * 64 < list->linearPrefix; word++) {
+        if (!matches[word])
+            continue;
+
+        long long node = word * 64 + __builtin_ctzll(matches[word]);
+        if (node < (long long) list->linearPrefix)
+            result = node;
+        break;
+    }
+
+    if (found && result == -1 && pool == list && !pool->sharers && found <= KEY_ORDER_CANDIDATES)
+        result = resolveKeyOrder(list, matches, found, false);
+
+    for (long long node = list->head; found && result == -1 && node != -1; node = listNext(list, node)) {
+        if ((matches[node / 64] >> (node % 64)) & 1)
+            result = node;
+    }
+
+    return result;
+}
+
+/**
+ * Function that finds last node of the list with the given inline key.
+ * If the list occupies exactly cells [0, size) in order the highest matching cell is the answer,
+ * otherwise the order is resolved among the matches as in findFirstKey or links are followed
+ * from the tail
+ * @param list Pointer to list_t
+ * @param key Key to look for
+ * @return Physical address of the element, -1 if there is no such element or keys are not enabled
+ */
+
+long long findLastKey(list_t *list, long long key) {
+    assert(list);
+
+    list_t *pool = list->pool;
+
+    if (!pool->keys || list->size == 0)
+        return -1;
+
+    unsigned long long *matches = pool->keyMatches;
+    size_t found = scanKeys(pool, key, matches);
+    long long result = -1;
+
+    if (found && list->linearPrefix == list->size) {
+        for (long long word = (long long) (list->size - 1) / 64; word >= 0; word--) {
+            unsigned long long match = matches[word];
+
+            if (word == (long long) (list->size - 1) / 64 && list->size % 64)
+                match &= (1ull << (list->size % 64)) - 1;
+
+            if (match) {
+                result = word * 64 + 63 - __builtin_clzll(match);
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    if (found && pool == list && !pool->sharers && found <= KEY_ORDER_CANDIDATES)
+        result = resolveKeyOrder(list, matches, found, true);
+
+    for (long long node = list->tail; found && result == -1 && node != -1; node = listPrev(list, node)) {
+        if ((matches[node / 64] >> (node % 64)) & 1)
+            result = node;
+    }
+
+    return result;
+}
+
+/**
+ * Function that sets or clears occupancy bit of the cell
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @param occupied True if the cell is taken by some list, False if it is empty
+ */
+
+void markOccupied(list_t *list, long long node, bool occupied) {
+    assert(list);
+
+    unsigned long long &word = list->pool->occupied[node >> LIST_CHUNK_SHIFT][(node & LIST_CHUNK_MASK) / 64];
+
+    if (occupied)
+        word |= 1ull << (node % 64);
+    else
+        word &= ~(1ull << (node % 64));
+}
+
+/**
+ * Function that checks whether the cell is taken by some list
+ * @param list Pointer to list_t
+ * @param node Physical number of cell
+ * @return True if the cell is occupied, False if it is empty
+ */
+
+bool isOccupied(list_t *list, long long node) {
+    assert(list);
+
+    return (list->pool->occupied[node >> LIST_CHUNK_SHIFT][(node & LIST_CHUNK_MASK) / 64] >> (node % 64)) & 1;
+}
+
+/**
+ * Function that marks cells [0, occupied) of the pool as occupied and all others as empty
+ * @param pool Pointer to list_t that owns cells
+ * @param occupied Number of occupied cells
+ */
+
+void resetOccupancy(list_t *pool, size_t occupied) {
+    assert(pool);
+
+    for (size_t chunk = 0; chunk < pool->chunks; chunk++) {
+        for (size_t word = 0; word < LIST_CHUNK_SIZE / 64; word++) {
+            size_t first = chunk * LIST_CHUNK_SIZE + word * 64;
+
+            if (first + 64 <= occupied)
+                pool->occupied[chunk][word] = ~0ull;
+            else if (first < occupied)
+                pool->occupied[chunk][word] = (1ull << (occupied - first)) - 1;
+            else
+                pool->occupied[chunk][word] = 0;
+        }
+    }
+}
+
+/**
+ * Function that calls func for values of all nodes of the list in physical order.
+ * Cells are read sequentially and empty ones are skipped by the occupancy bitmap, so the walk
+ * streams through memory instead of following links. Lists that share their pool are walked
+ * in logical order, since the bitmap cannot tell their nodes apart
+ * @param list Pointer to list_t
+ * @param func Function that gets value and arg
+ * @param arg Argument for func
+ */
+
+void forEachPhysical(list_t *list, void (*func)(void *, void *), void *arg) {
+    assert(list);
+    assert(func);
+
+    list_t *pool = list->pool;
+
+    if (pool != list || pool->sharers) {
+        for (long long node = list->head; node != -1; node = listNext(list, node))
+            func(listValue(list, node), arg);
+        return;
+    }
+
+    for (size_t chunk = 0; chunk < pool->chunks; chunk++) {
+        long long base = (long long) (chunk * LIST_CHUNK_SIZE);
+
+        for (size_t word = 0; word < LIST_CHUNK_SIZE / 64; word++) {
+            for (unsigned long long bits = pool->occupied[chunk][word]; bits; bits &= bits - 1)
+                func(listValue(pool, base + word * 64 + __builtin_ctzll(bits)), arg);
+        }
+    }
+}
+
+/**
+ * Function that finds some node whose value satisfies pred, not necessarily the first one.
+ * Cells are checked in physical order like in forEachPhysical
+ * @param list Pointer to list_t
+ * @param pred Predicate that gets value and arg
+ * @param arg Argument for pred
+ * @return Physical address of the element, -1 if there is no such element
+ */
+
+long long findAny(list_t *list, bool (*pred)(void *, void *), void *arg) {
+    assert(list);
+    assert(pred);
+
+    list_t *pool = list->pool;
+
+    if (pool != list || pool->sharers) {
+        for (long long node = list->head; node != -1; node = listNext(list, node)) {
+            if (pred(listValue(list, node), arg))
+                return node;
+        }
+        return -1;
+    }
+
+    for (size_t chunk = 0; chunk < pool->chunks; chunk++) {
+        long long base = (long long) (chunk * LIST_CHUNK_SIZE);
+
+        for (size_t word = 0; word < LIST_CHUNK_SIZE / 64; word++) {
+            for (unsigned long long bits = pool->occupied[chunk][word]; bits; bits &= bits - 1) {
+                long long node = base + word * 64 + __builtin_ctzll(bits);
+
+                if (pred(listValue(pool, node), arg))
+                    return node;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Function that counts nodes whose values satisfy pred.
+ * Cells are checked in physical order like in forEachPhysical
+ * @param list Pointer to list_t
+ * @param pred Predicate that gets value and arg
+ * @param arg Argument for pred
+ * @return Number of such nodes
+ */
+
+size_t countIf(list_t *list, bool (*pred)(void *, void *), void *arg) {
+    assert(list);
+    assert(pred);
+
+    list_t *pool = list->pool;
+    size_t count = 0;
+
+    if (pool != list || pool->sharers) {
+        for (long long node = list->head; node != -1; node = listNext(list, node))
+            count += pred(listValue(list, node), arg);
+        return count;
+    }
+
+    for (size_t chunk = 0; chunk < pool->chunks; chunk++) {
+        long long base = (long long) (chunk * LIST_CHUNK_SIZE);
+
+        for (size_t word = 0; word < LIST_CHUNK_SIZE / 64; word++) {
+            for (unsigned long long bits = pool->occupied[chunk][word]; bits; bits &= bits - 1)
+                count += pred(listValue(pool, base + word * 64 + __builtin_ctzll(bits)), arg);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Function that deletes node
+ * @param list Pointer to list_t
+ * @param node Physical adress of the node
+ */
+
+void deleteNode(list_t *list, long long node) {
+    assert(list);
+    assert(node >= 0);
+    assert(node < (long long) list->pool->capacity);
+
+    patchJumpIndexDelete(list, node);
+
+    if (listPrev(list, node) != -1)
+        listNext(list, listPrev(list, node)) = listNext(list, node);
+    else
+        list->head = listNext(list, node);
+
+    if (listNext(list, node) != -1)
+        listPrev(list, listNext(list, node)) = listPrev(list, node);
+    else
+        list->tail = listPrev(list, node);
+
+    listNext(list, node) = -1;
+    listValue(list, node) = nullptr;
+    list->size--;
+    shrinkLinearPrefix(list, node);
+    // stackPush(&list->free, node);
+    addEmpty(list, node);
+}
+
+/**
+ * Function that adds chain of cells linked through prev to the list of the empty cells
+ * @param list Pointer to list_t
+ * @param first First cell of the chain
+ * @param last Last cell of the chain
+ * @param count Number of cells in the chain
+ */
+
+void spliceEmpty(list_t *list, long long first, long long last, size_t count) {
+    assert(list);
+
+    if (first == -1)
+        return;
+
+    list_t *pool = list->pool;
+
+    if (pool->slots) {
+        for (long long node = first; node != last; node = listPrev(pool, node))
+            pool->slots->link[node].store(listPrev(pool, node), std::memory_order_relaxed);
+
+        pushSlots(pool->slots, first, last);
+        return;
+    }
+
+    listPrev(pool, last) = pool->emptyHead;
+    pool->emptyHead = first;
+    pool->freeCells += count;
+}
+
+/**
+ * Function that deletes several nodes at once. Consecutive deleted nodes are unlinked
+ * as one run and all cells are returned to the list of the empty cells by one splice
+ * @param list Pointer to list_t
+ * @param nodes Physical numbers of nodes, duplicates are allowed
+ * @param n Number of nodes
+ * @return Number of deleted nodes, 0 if allocation error occures and the list is not changed
+ */
+
+size_t deleteNodes(list_t *list, const long long *nodes, size_t n) {
+    assert(list);
+    assert(nodes || n == 0);
+
+    if (n == 0)
+        return 0;
+
+    unsigned long long *marked = (unsigned long long *) calloc((list->pool->capacity + 63) / 64,
+                                                               sizeof(unsigned long long));
+    if (!marked)
+        return 0;
+
+    long long lowest = nodes[0];
+
+    for (size_t i = 0; i < n; i++) {
+        assert(nodes[i] >= 0 && nodes[i] < (long long) list->pool->capacity);
+
+        marked[nodes[i] / 64] |= 1ull << (nodes[i] % 64);
+        if (nodes[i] < lowest)
+            lowest = nodes[i];
+    }
+
+    long long freedFirst = -1;
+    long long freedLast = -1;
+    size_t deleted = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        long long start = nodes[i];
+        long long before = listPrev(list, start);
+
+        if (!(marked[start / 64] >> (start % 64) & 1))
+            continue;
+        if (before != -1 && (marked[before / 64] >> (before % 64) & 1))
+            continue;
+
+        long long node = start;
+
+        while (node != -1 && (marked[node / 64] >> (node % 64) & 1)) {
+            long long next = listNext(list, node);
+
+            marked[node / 64] &= ~(1ull << (node % 64));
+            clearNodeKey(list, node);
+            markOccupied(list, node, false);
+            listNext(list, node) = -1;
+            listValue(list, node) = nullptr;
+            listPrev(list, node) = freedFirst;
+            if (freedLast == -1)
+                freedLast = node;
+            freedFirst = node;
+            deleted++;
+
+            node = next;
+        }
+
+        if (before != -1)
+            listNext(list, before) = node;
+        else
+            list->head = node;
+
+        if (node != -1)
+            listPrev(list, node) = before;
+        else
+            list->tail = before;
+    }
+
+    free(marked);
+
+    spliceEmpty(list, freedFirst, freedLast, deleted);
+    list->size -= deleted;
+    shrinkLinearPrefix(list, lowest);
+    invalidateJumpIndex(list);
+
+    return deleted;
+}
+
+/**
+ * Function that deletes all nodes whose values satisfy the predicate in one pass over the list
+ * @param list Pointer to list_t
+ * @param pred Predicate that takes value and arg
+ * @param arg Void pointer passed to predicate
+ * @return Number of deleted nodes
+ */
+
+size_t removeIf(list_t *list, bool (*pred)(void *, void *), void *arg) {
+    assert(list);
+    assert(pred);
+
+    long long freedFirst = -1;
+    long long freedLast = -1;
+    long long lowest = list->pool->capacity;
+    long long kept = -1;
+    long long node = list->head;
+    size_t deleted = 0;
+
+    while (node != -1) {
+        long long next = listNext(list, node);
+
+        if (pred(listValue(list, node), arg)) {
+            clearNodeKey(list, node);
+            markOccupied(list, node, false);
+            listNext(list, node) = -1;
+            listValue(list, node) = nullptr;
+            listPrev(list, node) = freedFirst;
+            if (freedLast == -1)
+                freedLast = node;
+            freedFirst = node;
+            if (node < lowest)
+                lowest = node;
+            deleted++;
+        } else {
+            if (listPrev(list, node) != kept) {
+                listPrev(list, node) = kept;
+                if (kept != -1)
+                    listNext(list, kept) = node;
+                else
+                    list->head = node;
+            }
+            kept = node;
+        }
+
+        node = next;
+    }
+
+    if (deleted == 0)
+        return 0;
+
+    if (kept != -1)
+        listNext(list, kept) = -1;
+    else
+        list->head = -1;
+    list->tail = kept;
+
+    spliceEmpty(list, freedFirst, freedLast, deleted);
+    list->size -= deleted;
+    shrinkLinearPrefix(list, lowest);
+    invalidateJumpIndex(list);
+
+    return deleted;
+}
+
+/**
+ * Function that moves nodes from first to last from src list after the given element of dst list.
+ * If lists share the pool the nodes are relinked in O(1), otherwise values are migrated
+ * into cells of dst pool in O(count) and cells of src are freed by one splice
+ * @param dst Pointer to destination list_t
+ * @param after Physical number of element of dst, -1 to move to the head
+ * @param src Pointer to source list_t, may be dst if after is not in the range
+ * @param first Physical number of the first moved node
+ * @param last Physical number of the last moved node
+ * @param count Number of nodes from first to last
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int spliceRange(list_t *dst, long long after, list_t *src, long long first, long long last, size_t count) {
+    assert(dst);
+    assert(src);
+    assert(first >= 0);
+    assert(last >= 0);
+    assert(count > 0);
+
+    if (dst != src && dst->maxsize - dst->size < count)
+        return 0;
+
+    long long before = listPrev(src, first);
+    long long behind = listNext(src, last);
+    long long afterNext = -1;
+
+    if (dst->pool != src->pool) {
+        list_t *pool = dst->pool;
+
+        while (pool->freeCells < count) {
+            if (!growList(pool))
+                return 0;
+        }
+
+        if (src->pool->keys && !enableKeys(dst))
+            return 0;
+
+        long long freedFirst = -1;
+        long long freedLast = -1;
+        long long node = first;
+        long long copy = -1;
+        long long copyPrev = after;
+
+        afterNext = (after == -1) ? dst->head : listNext(dst, after);
+
+        for (size_t i = 0; i < count; i++) {
+            long long next = listNext(src, node);
+
+            copy = getEmpty(dst);
+            listValue(dst, copy) = listValue(src, node);
+            if (hasNodeKey(src, node))
+                setNodeKey(dst, copy, getNodeKey(src, node));
+            clearNodeKey(src, node);
+            markOccupied(src, node, false);
+            listPrev(dst, copy) = copyPrev;
+            if (copyPrev != -1)
+                listNext(dst, copyPrev) = copy;
+            else
+                dst->head = copy;
+            copyPrev = copy;
+
+            listNext(src, node) = -1;
+            listValue(src, node) = nullptr;
+            listPrev(src, node) = freedFirst;
+            if (freedLast == -1)
+                freedLast = node;
+            freedFirst = node;
+
+            node = next;
+        }
+
+        assert(node == behind);
+
+        spliceEmpty(src, freedFirst, freedLast, count);
+        first = -1;
+        last = copy;
+    }
+
+    if (before != -1)
+        listNext(src, before) = behind;
+    else
+        src->head = behind;
+
+    if (behind != -1)
+        listPrev(src, behind) = before;
+    else
+        src->tail = before;
+
+    src->size -= count;
+    shrinkLinearPrefix(src, first == -1 ? 0 : first);
+    invalidateJumpIndex(src);
+
+    if (first != -1) {
+        afterNext = (after == -1) ? dst->head : listNext(dst, after);
+
+        listPrev(dst, first) = after;
+        if (after != -1)
+            listNext(dst, after) = first;
+        else
+            dst->head = first;
+    }
+
+    listNext(dst, last) = afterNext;
+    if (afterNext != -1)
+        listPrev(dst, afterNext) = last;
+    else
+        dst->tail = last;
+
+    dst->size += count;
+    shrinkLinearPrefix(dst, after + 1);
+    invalidateJumpIndex(dst);
+
+    return 1;
+}
+
+/**
+ * Function that moves all nodes of src list to the tail of dst list
+ * @param dst Pointer to destination list_t
+ * @param src Pointer to source list_t
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int concatLists(list_t *dst, list_t *src) {
+    assert(dst);
+    assert(src);
+    assert(dst != src);
+
+    if (src->size == 0)
+        return 1;
+
+    return spliceRange(dst, dst->tail, src, src->head, src->tail, src->size);
+}
+
+/**
+ * Function that splits list before the given node. The new list shares the pool with the
+ * given one, its size is counted from both ends at once, i. e. in O(min(k, n - k))
+ * @param list Pointer to list_t
+ * @param node Physical number of the first node of the new list
+ * @return Pointer to new list_t with nodes from node to tail
+ */
+
+list_t *splitList(list_t *list, long long node) {
+    assert(list);
+    assert(node >= 0);
+
+    list_t *newList = createSharedList(list);
+    long long forward = node;
+    long long backward = listPrev(list, node);
+    size_t steps = 0;
+    size_t count = 0;
+
+    while (true) {
+        if (forward == -1) {
+            count = steps;
+            break;
+        }
+
+        if (backward == -1) {
+            count = list->size - steps;
+            break;
+        }
+
+        forward = listNext(list, forward);
+        backward = listPrev(list, backward);
+        steps++;
+    }
+
+    spliceRange(newList, -1, list, node, list->tail, count);
+
+    return newList;
+}
+
+/**
+ * Function that validates the list
+ * @param list Pointer to list_t
+ * @return List Validity value
+ */
+
+listValidity validateList(list_t *list) {
+    if (!list)
+        return LIST_NOT_FOUND;
+
+    size_t size = list->size;
+    long long node = list->head;
+
+    if (size == 0)
+        return (list->head == -1 && list->tail == -1) ? OK : CORRUPTED;
+
+    for (size_t i = 0; i < size - 1; i++) {
+        if (node == -1)
+            return CORRUPTED;
+
+        node = listNext(list, node);
+    }
+
+    if (list->tail != node)
+        return CORRUPTED;
+
+    return OK;
+}
+
+/**
+ * Function that prepares dump buffer
+ * @param buffer Pointer to dumpBuffer_t
+ * @param file File where the buffer is flushed, nullptr to keep the whole dump in memory
+ * @param capacity Initial size of the buffer
+ * @return False if memory cannot be allocated, True otherwise
+ */
+
+bool initDumpBuffer(dumpBuffer_t *buffer, FILE *file, size_t capacity) {
+    assert(buffer);
+    assert(capacity > 0);
+
+    buffer->file = file;
+    buffer->data = (char *) malloc(capacity);
+    buffer->size = 0;
+    buffer->capacity = buffer->data ? capacity : 0;
+    buffer->failed = !buffer->data;
+
+    return buffer->data != nullptr;
+}
+
+/**
+ * Function that returns place for n more bytes at the end of the buffer. Caller writes there
+ * and adds the number of written bytes to size
+ * @param buffer Pointer to dumpBuffer_t
+ * @param n Number of bytes, must not exceed capacity if the buffer has file
+ * @return Pointer to the place, nullptr if memory cannot be allocated
+ */
+
+char *dumpReserve(dumpBuffer_t *buffer, size_t n) {
+    if (buffer->capacity - buffer->size >= n)
+        return buffer->data + buffer->size;
+
+    if (buffer->file) {
+        assert(n <= buffer->capacity);
+        flushDump(buffer);
+        return buffer->data;
+    }
+
+    size_t capacity = std::max(buffer->capacity * 2, buffer->size + n);
+    char *data = (char *) realloc(buffer->data, capacity);
+    if (!data) {
+        buffer->failed = true;
+        return nullptr;
+    }
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+
+    return buffer->data + buffer->size;
+}
+
+/**
+ * Function that appends bytes to the dump
+ * @param buffer Pointer to dumpBuffer_t
+ * @param data Bytes
+ * @param n Number of bytes
+ */
+
+void dumpBytes(dumpBuffer_t *buffer, const char *data, size_t n) {
+    if (buffer->file && n > buffer->capacity) {
+        flushDump(buffer);
+        buffer->failed = buffer->failed || fwrite(data, 1, n, buffer->file) != n;
+        return;
+    }
+
+    char *place = dumpReserve(buffer, n);
+    if (!place)
+        return;
+
+    memcpy(place, data, n);
+    buffer->size += n;
+}
+
+/**
+ * Function that appends string to the dump
+ * @param buffer Pointer to dumpBuffer_t
+ * @param str Null-terminated string
+ */
+
+void dumpString(dumpBuffer_t *buffer, const char *str) {
+    dumpBytes(buffer, str, strlen(str));
+}
+
+/**
+ * Function that appends decimal text of number to the dump, two digits per step
+ * @param buffer Pointer to dumpBuffer_t
+ * @param number Number
+ */
+
+void dumpInteger(dumpBuffer_t *buffer, long long number) {
+    static const char pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                "8081828384858687888990919293949596979899";
+    char digits[20];
+    char *begin = digits + sizeof(digits);
+    unsigned long long magnitude = number < 0 ? 0 - (unsigned long long) number : (unsigned long long) number;
+
+    while (magnitude >= 100) {
+        begin -= 2;
+        memcpy(begin, pairs + magnitude % 100 * 2, 2);
+        magnitude /= 100;
+    }
+
+    if (magnitude >= 10) {
+        begin -= 2;
+        memcpy(begin, pairs + magnitude * 2, 2);
+    } else {
+        *--begin = (char) ('0' + magnitude);
+    }
+
+    if (number < 0)
+        *--begin = '-';
+
+    dumpBytes(buffer, begin, digits + sizeof(digits) - begin);
+}
+
+/**
+ * Function that writes buffered bytes to the file, does nothing if the buffer has no file
+ * @param buffer Pointer to dumpBuffer_t
+ */
+
+void flushDump(dumpBuffer_t *buffer) {
+    if (!buffer->file)
+        return;
+
+    buffer->failed = buffer->failed || fwrite(buffer->data, 1, buffer->size, buffer->file) != buffer->size;
+    buffer->size = 0;
+}
+
+/**
+ * Function that frees memory of the buffer without flushing it
+ * @param buffer Pointer to dumpBuffer_t
+ */
+
+void freeDumpBuffer(dumpBuffer_t *buffer) {
+    free(buffer->data);
+    buffer->data = nullptr;
+    buffer->size = buffer->capacity = 0;
+}
+
+/**
+ * Function that dumps list
+ * @param list Pointer to list
+ * @param dumpFilename Dump filename
+ * @param nodeDump Optional function that renders value into the buffer
+ * @param options Optional pointer to dumpOptions_t with DUMP_DOT or DUMP_SVG format, nullptr for dot
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int dumpList(list_t *list, const char *dumpFilename, void (*nodeDump)(dumpBuffer_t *, list_t *, long long),
+             const dumpOptions_t *options) {
+    assert(list);
+    assert(dumpFilename);
+    assert(!options || options->format == DUMP_DOT || options->format == DUMP_SVG);
+
+    FILE *dumpFile = fopen(dumpFilename, "w");
+    dumpBuffer_t buffer = {};
+    if (!dumpFile)
+        return 0;
+    initDumpBuffer(&buffer, dumpFile);
+
+    if (options && options->format == DUMP_SVG)
+        dumpSvgChain(&buffer, list, nodeDump);
+    else if (options && options->clustered)
+        dumpChainClusters(&buffer, list, nodeDump);
+    else
+        dumpChainDot(&buffer, list, nodeDump);
+
+    flushDump(&buffer);
+    freeDumpBuffer(&buffer);
+
+    int written = !buffer.failed;
+    written = (fclose(dumpFile) == 0) && written;
+
+    return written;
+}
+
+/**
+ * Function that dumps nodes of the list and links between them in dot format
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nodeDump Optional function that renders value into the buffer
+ */
+
+void dumpChainDot(dumpBuffer_t *buffer, list_t *list, void (*nodeDump)(dumpBuffer_t *, list_t *, long long)) {
+    dumpString(buffer, "digraph {\n");
+
+    long long node = list->head;
+
+    for (bool first = true; first || node != list->tail; first = false) {
+        long long shown = first ? node : listNext(list, node);
+
+        dumpString(buffer, "node");
+        dumpInteger(buffer, shown);
+        dumpString(buffer, "[label=\"{{");
+        dumpInteger(buffer, shown);
+        dumpString(buffer, "}");
+        if (nodeDump) {
+            dumpString(buffer, "|{");
+            (*nodeDump)(buffer, list, shown);
+            dumpString(buffer, "}");
+        }
+        dumpString(buffer, "}\",shape=record];\n");
+
+        if (first)
+            continue;
+
+        dumpString(buffer, "node");
+        dumpInteger(buffer, node);
+        dumpString(buffer, " -> node");
+        dumpInteger(buffer, shown);
+        dumpString(buffer, ";\nnode");
+        dumpInteger(buffer, shown);
+        dumpString(buffer, " -> node");
+        dumpInteger(buffer, node);
+        dumpString(buffer, ";\n");
+        node = shown;
+    }
+
+    dumpString(buffer, "Head -> node");
+    dumpInteger(buffer, list->head);
+    dumpString(buffer, ";\nnode");
+    dumpInteger(buffer, list->tail);
+    dumpString(buffer, " -> Tail;\n}");
+}
+
+/**
+ * Function that dumps list in dot format with runs of nodes, which are adjacent both logically
+ * and physically, collapsed into one node with the range of cells and positions. Single nodes
+ * are rendered by nodeDump, so the size of the dump depends on fragmentation of the list, not on
+ * its size. The linearized prefix is taken as one run without walking it
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nodeDump Optional function that renders value into the buffer
+ */
+
+void dumpChainClusters(dumpBuffer_t *buffer, list_t *list, void (*nodeDump)(dumpBuffer_t *, list_t *, long long)) {
+    dumpString(buffer, "digraph {\n");
+
+    long long node = list->head;
+    size_t position = 0;
+    long long cluster = 0;
+
+    while (node != -1) {
+        long long first = node;
+        long long step = 0;
+        size_t count = 1;
+
+        if (position == 0 && list->linearPrefix > 1) {
+            node = (long long) list->linearPrefix - 1;
+            count = list->linearPrefix;
+            step = 1;
+        }
+
+        while (node != list->tail) {
+            long long next = listNext(list, node);
+            long long delta = next - node;
+
+            if ((delta != 1 && delta != -1) || (step && delta != step) || listPrev(list, next) != node)
+                break;
+
+            step = delta;
+            node = next;
+            count++;
+        }
+
+        dumpString(buffer, "cluster");
+        dumpInteger(buffer, cluster);
+        dumpString(buffer, "[label=\"{{");
+        dumpInteger(buffer, first);
+        if (count > 1) {
+            dumpString(buffer, "..");
+            dumpInteger(buffer, node);
+            dumpString(buffer, "}|{positions ");
+            dumpInteger(buffer, (long long) position);
+            dumpString(buffer, "..");
+            dumpInteger(buffer, (long long) (position + count - 1));
+            dumpString(buffer, "}|{");
+            dumpInteger(buffer, (long long) count);
+            dumpString(buffer, " nodes");
+        } else if (nodeDump) {
+            dumpString(buffer, "}|{");
+            nodeDump(buffer, list, first);
+        }
+        dumpString(buffer, "}}\",shape=record];\n");
+
+        if (cluster > 0) {
+            dumpString(buffer, "cluster");
+            dumpInteger(buffer, cluster - 1);
+            dumpString(buffer, " -> cluster");
+            dumpInteger(buffer, cluster);
+            dumpString(buffer, ";\ncluster");
+            dumpInteger(buffer, cluster);
+            dumpString(buffer, " -> cluster");
+            dumpInteger(buffer, cluster - 1);
+            dumpString(buffer, ";\n");
+        }
+
+        position += count;
+        cluster++;
+
+        node = node == list->tail ? -1 : listNext(list, node);
+    }
+
+    if (cluster > 0) {
+        dumpString(buffer, "Head -> cluster0;\ncluster");
+        dumpInteger(buffer, cluster - 1);
+        dumpString(buffer, " -> Tail;\n");
+    }
+    dumpString(buffer, "}");
+}
+
+/**
+ * Function that splits cells of the pool into runs for clustered physical dump
+ * @param list Pointer to list
+ * @param runs Place for the array of runs in physical order, caller frees it
+ * @return Number of runs
+ */
+
+size_t collectCellRuns(list_t *list, cellRun_t **runs) {
+    long long capacity = (long long) list->pool->capacity;
+    size_t count = 0;
+    size_t allocated = 16;
+
+    *runs = (cellRun_t *) calloc(allocated, sizeof(cellRun_t));
+
+    for (long long cell = 0; cell < capacity && *runs;) {
+        bool occupied = isOccupied(list, cell);
+        int direction = 0;
+        long long last = cell;
+
+        while (last + 1 < capacity && isOccupied(list, last + 1) == occupied) {
+            bool up = occupied ? last != list->tail && listNext(list, last) == last + 1 && listPrev(list, last + 1) == last
+                               : listPrev(list, last) == last + 1;
+            bool down = occupied ? last + 1 != list->tail && listNext(list, last + 1) == last &&
+                                   listPrev(list, last) == last + 1
+                                 : listPrev(list, last + 1) == last;
+
+            if (up && direction >= 0)
+                direction = 1;
+            else if (down && direction <= 0)
+                direction = -1;
+            else
+                break;
+
+            last++;
+        }
+
+        if (count == allocated) {
+            allocated *= 2;
+            cellRun_t *grown = (cellRun_t *) realloc(*runs, allocated * sizeof(cellRun_t));
+            if (!grown) {
+                free(*runs);
+                *runs = nullptr;
+                return 0;
+            }
+            *runs = grown;
+        }
+
+        (*runs)[count++] = {cell, last, occupied, direction < 0};
+        cell = last + 1;
+    }
+
+    return *runs ? count : 0;
+}
+
+/**
+ * Function that finds run which contains the cell
+ * @param runs Runs in physical order
+ * @param count Number of runs
+ * @param cell Cell
+ * @return Number of the run
+ */
+
+size_t findCellRun(const cellRun_t *runs, size_t count, long long cell) {
+    size_t low = 0;
+    size_t high = count;
+
+    while (high - low > 1) {
+        size_t middle = (low + high) / 2;
+        if (runs[middle].first <= cell)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/**
+ * Function that dumps the table of cells in dot format with runs of cells collapsed into one cell
+ * of the table. Occupied runs are cells which follow each other in the list, empty runs are cells
+ * which follow each other in the list of the empty cells. Links are drawn between runs, so the
+ * size of the dump depends on fragmentation of the pool, not on its size
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nDump Optional node value dumper for runs of one cell
+ */
+
+void dumpCellClusters(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long)) {
+    cellRun_t *runs = nullptr;
+    size_t count = collectCellRuns(list, &runs);
+
+    dumpString(buffer, "digraph {\nmainNode[shape=none,\nlabel = <<table><tr>");
+
+    for (size_t i = 0; i < count; i++) {
+        const cellRun_t *run = &runs[i];
+        bool head = run->occupied && list->head >= run->first && list->head <= run->last;
+        bool tail = run->occupied && list->tail >= run->first && list->tail <= run->last;
+
+        dumpString(buffer, "<td port=\"run");
+        dumpInteger(buffer, (long long) i);
+        dumpString(buffer, "\" border=\"1\" bgcolor=\"");
+        dumpString(buffer, DUMP_DOT_COLORS[head ? 0 : tail ? 1 : run->occupied ? 3 : 2]);
+        dumpString(buffer, "\">");
+        dumpInteger(buffer, run->first);
+
+        if (run->last > run->first) {
+            dumpString(buffer, "..");
+            dumpInteger(buffer, run->last);
+            dumpString(buffer, "<br/>");
+            dumpInteger(buffer, run->last - run->first + 1);
+            dumpString(buffer, run->occupied ? " nodes" : " empty");
+        } else if (nDump) {
+            dumpString(buffer, "<br/>");
+            nDump(buffer, list, run->first);
+        }
+        dumpString(buffer, "</td>\n");
+    }
+
+    dumpString(buffer, "</tr></table>>\n];\n");
+
+    for (size_t i = 0; i < count; i++) {
+        const cellRun_t *run = &runs[i];
+        long long exit = run->descending ? run->first : run->last;
+        long long entry = run->descending ? run->last : run->first;
+        long long links[2] = {run->occupied && exit != list->tail ? listNext(list, exit) : -1,
+                              run->occupied ? (entry != list->head ? listPrev(list, entry) : -1)
+                                            : listPrev(list, exit)};
+
+        for (int side = 0; side < 2; side++) {
+            if (links[side] < 0 || links[side] >= (long long) list->pool->capacity)
+                continue;
+
+            dumpString(buffer, "mainNode:run");
+            dumpInteger(buffer, (long long) i);
+            dumpString(buffer, side ? ":s -> mainNode:run" : ":n -> mainNode:run");
+            dumpInteger(buffer, (long long) findCellRun(runs, count, links[side]));
+            dumpString(buffer, side == 0 ? ":n [color=\"forestgreen\"];\n" :
+                               run->occupied ? ":s [color=\"firebrick\"];\n" : ":s [color=\"gray\", style=\"dashed\"];\n");
+        }
+    }
+
+    dumpString(buffer, "}");
+    free(runs);
+}
+
+/**
+ * Function that tells what the cell is for coloring in dumps
+ * @param list Pointer to list
+ * @param i Cell
+ * @return 0 for head, 1 for tail, 2 for cells without next, 3 for other cells
+ */
+
+int physicalCellKind(list_t *list, long long i) {
+    if (i == list->head)
+        return 0;
+    if (i == list->tail)
+        return 1;
+    if (listNext(list, i) == -1)
+        return 2;
+
+    return 3;
+}
+
+/**
+ * Function that returns color of the cell in physical dump
+ * @param list Pointer to list
+ * @param i Cell
+ * @return Name of the color
+ */
+
+const char *physicalCellColor(list_t *list, long long i) {
+    return DUMP_DOT_COLORS[physicalCellKind(list, i)];
+}
+
+/**
+ * Function that chooses cells for listPhysicalDump with options. It works in time proportional
+ * to the window or to maxCells, not to the size of the pool
+ * @param list Pointer to list
+ * @param options Pointer to dumpOptions_t
+ * @param cells Place for the array of the chosen cells in physical order, caller frees it
+ * @return Number of the chosen cells
+ */
 
-long long getElementByPosition(list_t *list, size_t position);
+size_t selectDumpCells(list_t *list, const dumpOptions_t *options, long long **cells) {
+    assert(list);
+    assert(options);
+    assert(cells);
 
-long long getFirstElement(list_t *list);
+    long long *window = nullptr;
+    size_t count = 0;
+    long long begin = std::max(options->firstCell, 0ll);
+    long long end = options->lastCell == -1 ? (long long) list->pool->capacity
+                                            : std::min(options->lastCell, (long long) list->pool->capacity);
 
-long long getLastElement(list_t *list);
+    if (options->around != -1) {
+        assert(options->around >= 0 && options->around < (long long) list->pool->capacity);
 
-long long getNextElement(long long node);
+        long long first = options->around;
+        size_t before = 0;
 
-long long getPreviousElement(long long node);
+        while (before < options->radius && listPrev(list, first) != -1 && first != list->head) {
+            first = listPrev(list, first);
+            before++;
+        }
 
-long long findFirstNode(list_t *list, void *value, bool (*cmp)(void *, void *));
+        window = (long long *) calloc(before + options->radius + 1, sizeof(long long));
+        for (long long node = first; node != -1 && count <= before + options->radius; node = listNext(list, node)) {
+            window[count++] = node;
+            if (node == list->tail)
+                break;
+        }
+    } else {
+        count = begin < end ? (size_t) (end - begin) : 0;
+    }
 
-long long findLastNode(list_t *list, void *value, bool (*cmp)(void *, void *));
+    size_t chosen = options->maxCells && count > options->maxCells ? options->maxCells : count;
+    unsigned long long state = options->seed ? options->seed : 1;
 
-long long getEmpty(list_t *list);
+    *cells = (long long *) calloc(chosen + 1, sizeof(long long));
 
-void addEmpty(list_t *list, long long num);
+    for (size_t i = 0; i < chosen; i++) {
+        size_t position = i;
 
-listValidity validateList(list_t *list);
+        if (chosen < count) {
+            size_t from = i * count / chosen;
+            size_t to = (i + 1) * count / chosen;
 
-void deleteList(list_t **list);
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            position = from + state % (to - from);
+        }
 
-int addToHead(list_t *list, void *value);
+        (*cells)[i] = window ? window[position] : begin + (long long) position;
+    }
 
-int addToTail(list_t *list, void *value);
+    if (window)
+        std::sort(*cells, *cells + chosen);
 
-int insertAfter(list_t *list, long long elem, void *value);
+    free(window);
+    return chosen;
+}
 
-int insertBefore(list_t *list, long long elem, void *value);
+/**
+ * Function that dumps the chosen cells like listPhysicalDump does with the whole pool.
+ * Skipped cells are shown as "..." and only links between the chosen cells are drawn
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nDump Node value dumper
+ * @param cells Chosen cells in physical order
+ * @param count Number of the chosen cells
+ */
 
-void deleteNode(list_t *list, long long elem);
+void dumpSelectedCells(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                       const long long *cells, size_t count) {
+    dumpString(buffer, "digraph {\nmainNode[shape=none,\nlabel = <<table><tr>");
+
+    for (int row = 0; row < 2; row++) {
+        for (size_t i = 0; i < count; i++) {
+            if (i > 0 ? cells[i] != cells[i - 1] + 1 : cells[i] != 0)
+                dumpString(buffer, "<td border=\"0\">...</td>\n");
+
+            dumpString(buffer, "<td port=\"node");
+            dumpInteger(buffer, cells[i]);
+            dumpString(buffer, row ? "prev" : "next");
+            dumpString(buffer, "\" border=\"1\" bgcolor=\"");
+            dumpString(buffer, physicalCellColor(list, cells[i]));
+            dumpString(buffer, "\">");
+            if (row)
+                nDump(buffer, list, cells[i]);
+            else
+                dumpInteger(buffer, cells[i]);
+            dumpString(buffer, "</td>\n");
+        }
 
-void clearList(list_t *list);
+        if (count > 0 && cells[count - 1] != (long long) list->pool->capacity - 1)
+            dumpString(buffer, "<td border=\"0\">...</td>\n");
+        dumpString(buffer, row ? "</tr></table>>\n];\n" : "</tr>\n<tr>\n");
+    }
 
-void sortList(list_t *list);
+    bool hasEmpty = false;
 
-void dumpList(list_t *list, const char *dumpFilename, char *(*nodeDump)(list_t *, long long) = nullptr);
+    for (size_t i = 0; i < count; i++) {
+        long long node = cells[i];
 
-void listPhysicalDump(list_t *list, const char *dumpFilename, char *(*nodeDump)(list_t *, long long));
+        if (!isOccupied(list, node)) {
+            hasEmpty = true;
+            continue;
+        }
 
-char *nodeDump(list_t *list, long long node) { // Example function
-    static char str[65] = "";
-    sprintf(str, "{VALUE|%d}|{NEXT|%lld}|{PREVIOUS|%lld}", *(int *) (list->value[node]), list->next[node],
-            list->prev[node]);
-    return (char *) str;
-}
+        if (node != list->tail && std::binary_search(cells, cells + count, listNext(list, node))) {
+            dumpString(buffer, "mainNode:node");
+            dumpInteger(buffer, node);
+            dumpString(buffer, "next:n -> mainNode:node");
+            dumpInteger(buffer, listNext(list, node));
+            dumpString(buffer, "next:n [color=\"forestgreen\"];\n");
+        }
 
-char *nodeDumpClear(list_t *list, long long node) { // Example function
-    static char str[65] = "";
-    if (list->value[node])
-        sprintf(str, "VALUE: %d", *(int *) (list->value[node]));
-    else
-        sprintf(str, "EMPTY");
+        if (node != list->head && std::binary_search(cells, cells + count, listPrev(list, node))) {
+            dumpString(buffer, "mainNode:node");
+            dumpInteger(buffer, node);
+            dumpString(buffer, "prev:s -> mainNode:node");
+            dumpInteger(buffer, listPrev(list, node));
+            dumpString(buffer, "prev:s [color=\"firebrick\"];\n");
+        }
+    }
 
-    return (char *) str;
+    if (hasEmpty) {
+        dumpString(buffer, "{rank=same;\n");
+
+        for (size_t i = 0; i < count; i++) {
+            long long empty = cells[i];
+            if (isOccupied(list, empty))
+                continue;
+
+            dumpString(buffer, "empty");
+            dumpInteger(buffer, empty);
+            dumpString(buffer, " [label=\"");
+            dumpInteger(buffer, empty);
+            dumpString(buffer, "\", shape=box];\n");
+
+            long long next = listPrev(list, empty);
+            if (next != -1 && !isOccupied(list, next) && std::binary_search(cells, cells + count, next)) {
+                dumpString(buffer, "empty");
+                dumpInteger(buffer, empty);
+                dumpString(buffer, " -> empty");
+                dumpInteger(buffer, next);
+                dumpString(buffer, ";\n");
+            }
+        }
+        dumpString(buffer, "}\n;");
+    }
+
+    dumpString(buffer, "}");
 }
 
 /**
- * Function that performs unit testing
- * @return Lib validity
+ * Function that splits chain of links into segments of the given number of links
+ * @param list Pointer to list
+ * @param section SECTION_NEXT_LINKS, SECTION_PREV_LINKS or SECTION_EMPTY_LINKS
+ * @param first The first node of the chain
+ * @param items Number of links in a segment, 0 for the whole chain in one segment
+ * @param segments Segments are appended here
  */
 
-bool doUnitTesting() {
-    bool valid = true;
-    list_t *testList = createList(10);
-    UTEST(testList->head == -1, valid);
-    UTEST(testList->tail == -1, valid);
-    int vals[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
-
-    addToHead(testList, &vals[1]);
-    UTEST(testList->head == 0, valid);
-    UTEST(testList->tail == 0, valid);
-    UTEST(testList->size == 1, valid);
+void collectChainSegments(list_t *list, dumpSection section, long long first, size_t items,
+                          std::vector<dumpSegment_t> *segments) {
+    if (items == 0) {
+        segments->push_back({section, nullptr, first, (size_t) -1});
+        return;
+    }
 
-    addToTail(testList, &vals[8]);
-    UTEST(testList->tail == 1, valid);
-    UTEST(testList->head == 0, valid);
-    UTEST(testList->size == 2, valid);
+    long long end = section == SECTION_NEXT_LINKS ? list->tail : section == SECTION_PREV_LINKS ? list->head : -1;
+    long long node = first;
+    size_t count = 0;
 
-    insertAfter(testList, 1, &vals[9]);
-    UTEST(testList->size == 3, valid);
-    UTEST(testList->tail == 2, valid);
-    UTEST(testList->head == 0, valid);
+    while (section == SECTION_EMPTY_LINKS ? listPrev(list, node) != end : node != end) {
+        if (count % items == 0)
+            segments->push_back({section, nullptr, node, items});
 
-    insertBefore(testList, 0, &vals[0]);
-    UTEST(testList->size == 4, valid);
-    UTEST(testList->tail == 2, valid);
-    UTEST(testList->head == 3, valid);
+        node = section == SECTION_NEXT_LINKS ? listNext(list, node) : listPrev(list, node);
+        count++;
+    }
+}
 
-    UTEST(getElementByPosition(testList, 0) == 3, valid);
-    UTEST(getElementByPosition(testList, 1) == 0, valid);
-    UTEST(getElementByPosition(testList, 2) == 1, valid);
-    UTEST(getElementByPosition(testList, 3) == 2, valid);
+/**
+ * Function that splits dot dump of all cells into segments. Rows of the table are cut by
+ * physical numbers, chains of links are walked to find the first node of every segment
+ * @param list Pointer to list
+ * @param items Number of cells or links in a segment, 0 for one segment per section
+ * @param concurrent True to walk the three chains on separate threads
+ * @param segments Segments are appended here
+ */
 
-    for (int i = 2; i < 8; i++) {
-        insertAfter(testList, getElementByPosition(testList, i - 1), &vals[i]);
-        UTEST(testList->value[getElementByPosition(testList, i)] == &vals[i], valid);
+void collectDumpSegments(list_t *list, size_t items, bool concurrent, std::vector<dumpSegment_t> *segments) {
+    size_t capacity = list->pool->capacity;
+    size_t step = items ? items : std::max(capacity, (size_t) 1);
+    std::vector<dumpSegment_t> chains[3];
+    long long starts[3] = {list->head, list->tail, list->pool->emptyHead};
+    std::thread walkers[3];
+
+    for (int chain = 0; chain < 3; chain++) {
+        if (chain == 2 && starts[chain] == -1)
+            continue;
+
+        dumpSection section = (dumpSection) (SECTION_NEXT_LINKS + (chain == 2 ? 3 : chain));
+        if (concurrent)
+            walkers[chain] = std::thread(collectChainSegments, list, section, starts[chain], items, &chains[chain]);
+        else
+            collectChainSegments(list, section, starts[chain], items, &chains[chain]);
     }
 
-    UTEST(testList->size == 10, valid);
-    UTEST(!addToHead(testList, nullptr), valid);
-    UTEST(!addToTail(testList, nullptr), valid);
-    UTEST(!insertAfter(testList, 0, nullptr), valid);
-    UTEST(!insertBefore(testList, 0, nullptr), valid);
+    segments->push_back({SECTION_TEXT, "digraph {\nmainNode[shape=none,\nlabel = <<table><tr>", 0, 0});
+    for (size_t i = 0; i < capacity; i += step)
+        segments->push_back({SECTION_CELLS, nullptr, (long long) i, std::min(step, capacity - i)});
+    segments->push_back({SECTION_TEXT, "</tr>\n<tr>\n", 0, 0});
+    for (size_t i = 0; i < capacity; i += step)
+        segments->push_back({SECTION_VALUES, nullptr, (long long) i, std::min(step, capacity - i)});
+    segments->push_back({SECTION_TEXT, "</tr></table>>\n];\n", 0, 0});
+
+    for (int chain = 0; chain < 3; chain++) {
+        if (walkers[chain].joinable())
+            walkers[chain].join();
+
+        if (chain == 2 && starts[chain] != -1) {
+            segments->push_back({SECTION_TEXT, "{rank=same;\n", 0, 0});
+            segments->push_back({SECTION_EMPTY_HEAD, nullptr, starts[chain], 1});
+        }
 
-    deleteNode(testList, 3);
-    UTEST(testList->size == 9, valid);
-    UTEST(testList->head == 0, valid);
+        segments->insert(segments->end(), chains[chain].begin(), chains[chain].end());
 
-    deleteNode(testList, 2);
-    UTEST(testList->size == 8, valid);
-    UTEST(testList->tail == 1, valid);
+        if (chain == 2 && starts[chain] != -1)
+            segments->push_back({SECTION_TEXT, "}\n;", 0, 0});
+    }
 
-    UTEST(validateList(testList) == OK, valid);
-    listPhysicalDump(testList, "unitTestingPhysical.dot", nodeDumpClear);
-    sortList(testList);
-    listPhysicalDump(testList, "unitTestingSortedPhysical.dot", nodeDumpClear);
-    dumpList(testList, "unitTestingDump.dot", nodeDump);
-    deleteList(&testList);
-    UTEST(!testList, valid);
-    return valid;
+    segments->push_back({SECTION_TEXT, "}", 0, 0});
 }
 
+/**
+ * Function that formats one segment of dot dump of all cells
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nDump Node value dumper
+ * @param segment Pointer to dumpSegment_t
+ */
 
-int main() {
-    if (doUnitTesting())
-        printf(ANSI_COLOR_GREEN "##############################\nUnit testing finished successfully!\n##############################" ANSI_COLOR_RESET);
-    else
-        printf(ANSI_COLOR_RED "##############################\nUnit testing failed!\n##############################" ANSI_COLOR_RESET);
+void formatDumpSegment(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                       const dumpSegment_t *segment) {
+    long long node = segment->first;
+
+    switch (segment->section) {
+        case SECTION_TEXT:
+            dumpString(buffer, segment->text);
+            break;
+
+        case SECTION_CELLS:
+        case SECTION_VALUES:
+            for (long long i = node; i < node + (long long) segment->count; i++) {
+                dumpString(buffer, "<td port=\"node");
+                dumpInteger(buffer, i);
+                dumpString(buffer, segment->section == SECTION_CELLS ? "next\" border=\"1\" bgcolor=\""
+                                                                     : "prev\" border=\"1\" bgcolor=\"");
+                dumpString(buffer, physicalCellColor(list, i));
+                dumpString(buffer, "\">");
+                if (segment->section == SECTION_CELLS)
+                    dumpInteger(buffer, i);
+                else
+                    nDump(buffer, list, i);
+                dumpString(buffer, "</td>\n");
+            }
+            break;
+
+        case SECTION_NEXT_LINKS:
+            for (size_t i = 0; i < segment->count && node != list->tail; i++, node = listNext(list, node)) {
+                dumpString(buffer, "mainNode:node");
+                dumpInteger(buffer, node);
+                dumpString(buffer, "next:n -> mainNode:node");
+                dumpInteger(buffer, listNext(list, node));
+                dumpString(buffer, "next:n [color=\"forestgreen\"];\n");
+            }
+            break;
+
+        case SECTION_PREV_LINKS:
+            for (size_t i = 0; i < segment->count && node != list->head; i++, node = listPrev(list, node)) {
+                dumpString(buffer, "mainNode:node");
+                dumpInteger(buffer, node);
+                dumpString(buffer, "prev:s -> mainNode:node");
+                dumpInteger(buffer, listPrev(list, node));
+                dumpString(buffer, "prev:s [color=\"firebrick\"];\n");
+            }
+            break;
+
+        case SECTION_EMPTY_HEAD:
+            dumpString(buffer, "empty");
+            dumpInteger(buffer, node);
+            dumpString(buffer, " [label=\"");
+            dumpInteger(buffer, node);
+            dumpString(buffer, "\", shape=box];\n");
+            break;
+
+        case SECTION_EMPTY_LINKS:
+            for (size_t i = 0; i < segment->count && listPrev(list, node) != -1; i++, node = listPrev(list, node)) {
+                long long next = listPrev(list, node);
+
+                dumpString(buffer, "empty");
+                dumpInteger(buffer, next);
+                dumpString(buffer, " [label=\"");
+                dumpInteger(buffer, next);
+                dumpString(buffer, "\", shape=box];\nempty");
+                dumpInteger(buffer, node);
+                dumpString(buffer, " -> empty");
+                dumpInteger(buffer, next);
+                dumpString(buffer, ";\n");
+            }
+            break;
+    }
 }
 
 /**
- * List "constructor" i. e. function that creates and initializes list_t
- * @param maxsize Maximal size of list
- * @return Pointer to list_t
+ * Function that dumps every cell of the pool and the whole list of the empty cells in dot format
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nDump Node value dumper
  */
 
-list_t *createList(size_t maxsize) {
-    list_t *list = (list_t *) calloc(1, sizeof(list_t));
-    list->size = 0;
-    list->value = (void **) calloc(maxsize, sizeof(void *));
-    list->maxsize = maxsize;
-    list->next = (long long *) calloc(maxsize, sizeof(long long));
-    list->prev = (long long *) calloc(maxsize, sizeof(long long));
-    list->head = -1;
-    list->tail = -1;
-    list->emptyHead = 0;
-    //list->free = {};
-    //stackConstruct(&list->free, "ListFreeStack", maxsize, -1);
+void dumpAllCells(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long)) {
+    std::vector<dumpSegment_t> segments;
+    collectDumpSegments(list, 0, false, &segments);
 
-    for (long long i = maxsize - 1; i >= 0; i--) {
-        list->next[i] = -1;
-        list->prev[i] = i + 1;
-        //stackPush(&list->free, i);
-    }
-    list->prev[maxsize - 1] = -1;
-    return list;
+    for (const dumpSegment_t &segment : segments)
+        formatDumpSegment(buffer, list, nDump, &segment);
 }
 
 /**
- * Function that clears list
- * @param list Pointer to list_t
+ * Function that makes the same dump as dumpAllCells on several threads. Workers format segments
+ * of DUMP_SEGMENT_ITEMS cells or links into their own buffers, the calling thread writes them
+ * in order. Workers stay at most two segments per thread ahead of the writer, so memory does not
+ * depend on the size of the list. nDump must be safe to call from several threads
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nDump Node value dumper
+ * @param threads Number of formatting threads
  */
 
-void clearList(list_t *list) {
-    assert(list);
+void dumpAllCellsParallel(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                          unsigned threads) {
+    std::vector<dumpSegment_t> segments;
+    collectDumpSegments(list, DUMP_SEGMENT_ITEMS, true, &segments);
 
-    long long curNode = list->head;
-    long long next = -1;
+    size_t window = 2 * (size_t) threads;
+    std::vector<dumpBuffer_t> slots(window);
+    std::vector<bool> ready(segments.size(), false);
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t taken = 0;
+    size_t written = 0;
 
-    while (curNode != list->tail) {
-        next = list->next[curNode];
+    for (dumpBuffer_t &slot : slots)
+        initDumpBuffer(&slot, nullptr, DUMP_SEGMENT_ITEMS * 64);
 
-        list->next[curNode] = -1;
-        list->prev[curNode] = -1;
-        list->value[curNode] = (void *) list->emptyHead;
-        list->emptyHead = curNode;
-        // stackPush(&list->free, curNode);
+    auto work = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
 
-        curNode = next;
+        while (true) {
+            changed.wait(lock, [&]() { return taken == segments.size() || taken < written + window; });
+            if (taken == segments.size())
+                return;
+
+            size_t segment = taken++;
+            dumpBuffer_t *slot = &slots[segment % window];
+
+            lock.unlock();
+            slot->size = 0;
+            formatDumpSegment(slot, list, nDump, &segments[segment]);
+            lock.lock();
+
+            ready[segment] = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++)
+        workers.emplace_back(work);
+
+    for (size_t segment = 0; segment < segments.size(); segment++) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return (bool) ready[segment]; });
+        lock.unlock();
+
+        dumpBuffer_t *slot = &slots[segment % window];
+        buffer->failed = buffer->failed || slot->failed;
+        dumpBytes(buffer, slot->data, slot->size);
+
+        lock.lock();
+        written++;
+        changed.notify_all();
     }
 
-    list->head = -1;
-    list->tail = -1;
-    list->size = 0;
+    for (std::thread &worker : workers)
+        worker.join();
+
+    for (dumpBuffer_t &slot : slots)
+        freeDumpBuffer(&slot);
 }
 
 /**
- * List "destructor" i. e. function that deletes list
- * @param list Pointer to pointer to list
+ * Function that dumps state of the list as JSON Lines: the first line holds head, tail, size,
+ * capacity, maxsize and emptyHead, then every cell takes one line with its value as a number,
+ * next, prev and occupancy. Cells are chosen by options like in dot format
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param options Pointer to dumpOptions_t
  */
 
-void deleteList(list_t **list) {
-    assert(list);
-    assert(*list);
+void dumpJsonLines(dumpBuffer_t *buffer, list_t *list, const dumpOptions_t *options) {
+    dumpString(buffer, "{\"head\":");
+    dumpInteger(buffer, list->head);
+    dumpString(buffer, ",\"tail\":");
+    dumpInteger(buffer, list->tail);
+    dumpString(buffer, ",\"size\":");
+    dumpInteger(buffer, (long long) list->size);
+    dumpString(buffer, ",\"capacity\":");
+    dumpInteger(buffer, (long long) list->pool->capacity);
+    dumpString(buffer, ",\"maxsize\":");
+    if (list->pool->maxsize == LIST_UNBOUNDED)
+        dumpString(buffer, "null");
+    else
+        dumpInteger(buffer, (long long) list->pool->maxsize);
+    dumpString(buffer, ",\"emptyHead\":");
+    dumpInteger(buffer, list->pool->emptyHead);
+    dumpString(buffer, "}\n");
 
-    clearList(*list);
+    long long *cells = nullptr;
+    size_t count = 0;
+    long long begin = std::max(options->firstCell, 0ll);
 
-    //stackDestruct(&(*list)->free);
+    if (options->around != -1 || options->maxCells) {
+        count = selectDumpCells(list, options, &cells);
+    } else {
+        long long end = options->lastCell == -1 ? (long long) list->pool->capacity
+                                                : std::min(options->lastCell, (long long) list->pool->capacity);
+        count = begin < end ? (size_t) (end - begin) : 0;
+    }
 
-    free(*list);
-    *list = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        long long cell = cells ? cells[i] : begin + (long long) i;
+
+        dumpString(buffer, "{\"cell\":");
+        dumpInteger(buffer, cell);
+        dumpString(buffer, ",\"value\":");
+        dumpInteger(buffer, (long long) (uintptr_t) listValue(list, cell));
+        dumpString(buffer, ",\"next\":");
+        dumpInteger(buffer, listNext(list, cell));
+        dumpString(buffer, ",\"prev\":");
+        dumpInteger(buffer, listPrev(list, cell));
+        dumpString(buffer, isOccupied(list, cell) ? ",\"occupied\":true}\n" : ",\"occupied\":false}\n");
+    }
+
+    free(cells);
 }
 
 /**
- * Function that adds elements to list's head
- * @param list Pointer to list_t
- * @param value Void pointer to value
+ * Function that dumps binary image of the pool: dumpImageHeader_t, then values, next links,
+ * prev links of all cells and the occupancy bitmap. Chunks are written to the file as they are,
+ * so the dump costs only I/O
+ * @param buffer Pointer to dumpBuffer_t with file
+ * @param list Pointer to list
+ */
+
+void dumpBinaryImage(dumpBuffer_t *buffer, list_t *list) {
+    assert(buffer->file);
+
+    list_t *pool = list->pool;
+    dumpImageHeader_t header = {};
+
+    memcpy(header.magic, LIST_DUMP_MAGIC, sizeof(LIST_DUMP_MAGIC));
+    header.headerSize = sizeof(dumpImageHeader_t);
+    header.head = list->head;
+    header.tail = list->tail;
+    header.size = list->size;
+    header.capacity = pool->capacity;
+    header.maxsize = pool->maxsize == LIST_UNBOUNDED ? 0 : pool->maxsize;
+    header.emptyHead = pool->emptyHead;
+    header.chunkSize = LIST_CHUNK_SIZE;
+
+    dumpBytes(buffer, (const char *) &header, sizeof(header));
+    flushDump(buffer);
+
+    for (int array = 0; array < 4; array++) {
+        for (size_t chunk = 0; chunk < pool->chunks; chunk++) {
+            size_t cells = std::min(pool->capacity - chunk * LIST_CHUNK_SIZE, LIST_CHUNK_SIZE);
+
+#ifdef LIST_AOS_CELLS
+            if (array < 3) {
+                for (size_t cell = 0; cell < cells; cell++) {
+                    const listCell_t *record = &pool->cells[chunk][cell];
+                    const void *field = array == 0 ? (const void *) &record->value :
+                                        array == 1 ? (const void *) &record->next : (const void *) &record->prev;
+                    dumpBytes(buffer, (const char *) field, sizeof(long long));
+                }
+                flushDump(buffer);
+                continue;
+            }
+
+            const void *data = pool->occupied[chunk];
+#else
+            const void *data = array == 0 ? (const void *) pool->value[chunk] :
+                               array == 1 ? (const void *) pool->next[chunk] :
+                               array == 2 ? (const void *) pool->prev[chunk] : (const void *) pool->occupied[chunk];
+#endif
+            size_t bytes = array == 3 ? (cells + 63) / 64 * sizeof(unsigned long long) : cells * sizeof(long long);
+
+            buffer->failed = buffer->failed || fwrite(data, 1, bytes, buffer->file) != bytes;
+        }
+    }
+}
+
+/**
+ * Physical dump of memory
+ * @param list Pointer to list
+ * @param dumpFilename Where to saveDump
+ * @param nDump Node value dumper, may be nullptr for JSON Lines and binary formats
+ * @param options Optional pointer to dumpOptions_t, which selects format and limits the dump to
+ * a window or a sample of cells, so its cost depends on them instead of the size of the pool.
+ * Dot dump of all cells is formatted on options->threads threads or collapsed into runs of cells
+ * if options->clustered is set. nullptr for all cells in dot format on the calling thread
  * @return 0 if error occures, 1 otherwise
  */
 
-int addToHead(list_t *list, void *value) {
+int listPhysicalDump(list_t *list, const char *dumpFilename, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                     const dumpOptions_t *options) {
     assert(list);
+    assert(dumpFilename);
 
-    if (list->size == list->maxsize)
+    dumpFormat format = options ? options->format : DUMP_DOT;
+    FILE *dumpFile = fopen(dumpFilename, format == DUMP_BINARY ? "wb" : "w");
+    dumpBuffer_t buffer = {};
+    if (!dumpFile)
         return 0;
+    initDumpBuffer(&buffer, dumpFile);
+
+    if (format == DUMP_BINARY) {
+        dumpBinaryImage(&buffer, list);
+    } else if (format == DUMP_JSON_LINES) {
+        dumpJsonLines(&buffer, list, options);
+    } else if (format == DUMP_SVG) {
+        long long *cells = nullptr;
+        size_t count = selectDumpCells(list, options, &cells);
+
+        dumpSvgCells(&buffer, list, nDump, cells, count);
+        free(cells);
+    } else if (options && options->clustered) {
+        dumpCellClusters(&buffer, list, nDump);
+    } else if (options && (options->firstCell > 0 || options->lastCell != -1 || options->around != -1 ||
+                           options->maxCells)) {
+        long long *cells = nullptr;
+        size_t count = selectDumpCells(list, options, &cells);
+
+        dumpSelectedCells(&buffer, list, nDump, cells, count);
+        free(cells);
+    } else {
+        unsigned threads = options ? options->threads : 1;
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        if (threads > 1)
+            dumpAllCellsParallel(&buffer, list, nDump, threads);
+        else
+            dumpAllCells(&buffer, list, nDump);
+    }
 
-    long long temp = list->head;
-    long long newNode = getEmpty(list);
+    flushDump(&buffer);
+    freeDumpBuffer(&buffer);
 
-    // stackPop(&list->free, &newNode);
+    int written = !buffer.failed;
+    written = (fclose(dumpFile) == 0) && written;
 
-    list->value[newNode] = value;
+    return written;
+}
 
-    if (temp != -1) {
-        list->prev[temp] = newNode;
-    }
+/**
+ * Function that appends text to the dump with XML special characters escaped
+ * @param buffer Pointer to dumpBuffer_t
+ * @param data Text
+ * @param n Length of the text
+ */
 
-    list->head = newNode;
+void dumpEscaped(dumpBuffer_t *buffer, const char *data, size_t n) {
+    size_t plain = 0;
 
-    if (list->tail == -1) {
-        list->tail = newNode;
-    }
+    for (size_t i = 0; i < n; i++) {
+        const char *entity = data[i] == '&' ? "&amp;" : data[i] == '<' ? "&lt;" : data[i] == '>' ? "&gt;" :
+                             data[i] == '"' ? "&quot;" : nullptr;
+        if (!entity)
+            continue;
 
-    list->size++;
+        dumpBytes(buffer, data + plain, i - plain);
+        dumpString(buffer, entity);
+        plain = i + 1;
+    }
 
-    return 1;
+    dumpBytes(buffer, data + plain, n - plain);
 }
 
 /**
- * Function that returns position of an empty element
+ * Function that renders value of the node with nodeDump into the scratch buffer and appends it
+ * to the dump escaped. Scratch keeps its memory between calls, so rendering does not allocate
+ * @param buffer Pointer to dumpBuffer_t
+ * @param scratch Pointer to dumpBuffer_t without file
  * @param list Pointer to list
- * @return Physical number of empty cell
+ * @param nodeDump Node value dumper
+ * @param node Node
  */
 
-long long getEmpty(list_t *list) {
-    assert(list);
-
-    long long empty = list->emptyHead;
-    list->emptyHead = list->prev[empty];
-    list->prev[empty] = -1;
-    return empty;
+void dumpSvgText(dumpBuffer_t *buffer, dumpBuffer_t *scratch, list_t *list,
+                 void (*nodeDump)(dumpBuffer_t *, list_t *, long long), long long node) {
+    scratch->size = 0;
+    nodeDump(scratch, list, node);
+    dumpEscaped(buffer, scratch->data, scratch->size);
 }
 
 /**
- * Function that adds cell to the list of the empty cells
- * @param list Pointer to list_t
- * @param num Physical number of cell
+ * Function that starts SVG document with the arrow marker used by links
+ * @param buffer Pointer to dumpBuffer_t
+ * @param width Width of the picture
+ * @param height Height of the picture
  */
 
-void addEmpty(list_t *list, long long num) {
-    assert(list);
-
-    list->prev[num] = list->emptyHead;
-    list->emptyHead = num;
+void dumpSvgStart(dumpBuffer_t *buffer, long long width, long long height) {
+    dumpString(buffer, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+    dumpInteger(buffer, width);
+    dumpString(buffer, "\" height=\"");
+    dumpInteger(buffer, height);
+    dumpString(buffer, "\" font-family=\"monospace\" font-size=\"11\">\n<defs><marker id=\"arrow\" "
+                       "viewBox=\"0 0 10 10\" refX=\"10\" refY=\"5\" markerWidth=\"6\" markerHeight=\"6\" "
+                       "orient=\"auto-start-reverse\"><path d=\"M0,0L10,5L0,10z\"/></marker></defs>\n"
+                       "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n");
 }
 
 /**
- * Function that adds value to the tail of the list
- * @param list Pointer to list_t
- * @param value Void pointer to value
- * @return 0 if error occures, 1 otherwise
+ * Function that draws link between two points as a cubic curve which bends up or down
+ * @param buffer Pointer to dumpBuffer_t
+ * @param fromX, fromY Start of the link
+ * @param toX, toY End of the link
+ * @param bend Vertical offset of control points, negative bends up
+ * @param style Attributes of the path
  */
 
-int addToTail(list_t *list, void *value) {
-    assert(list);
-
-    if (list->size == list->maxsize)
-        return 0;
+void dumpSvgCurve(dumpBuffer_t *buffer, long long fromX, long long fromY, long long toX, long long toY, long long bend,
+                  const char *style) {
+    dumpString(buffer, "<path d=\"M");
+    dumpInteger(buffer, fromX);
+    dumpString(buffer, ",");
+    dumpInteger(buffer, fromY);
+    dumpString(buffer, "C");
+    dumpInteger(buffer, fromX);
+    dumpString(buffer, ",");
+    dumpInteger(buffer, fromY + bend);
+    dumpString(buffer, " ");
+    dumpInteger(buffer, toX);
+    dumpString(buffer, ",");
+    dumpInteger(buffer, toY + bend);
+    dumpString(buffer, " ");
+    dumpInteger(buffer, toX);
+    dumpString(buffer, ",");
+    dumpInteger(buffer, toY);
+    dumpString(buffer, "\" fill=\"none\" ");
+    dumpString(buffer, style);
+    dumpString(buffer, "/>\n");
+}
 
-    long long temp = list->head;
-    long long newNode = getEmpty(list);
+/**
+ * Function that draws the chosen cells as the table of listPhysicalDump in SVG. The table is cut
+ * into rows of SVG_ROW_CELLS columns, skipped cells take a "..." column. Next links bend above
+ * the table, prev links and links of the empty cells bend below it. Positions of cells are known
+ * without any layout, so the time is linear in the number of cells
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nDump Optional node value dumper
+ * @param cells Chosen cells in physical order
+ * @param count Number of the chosen cells
+ */
 
-    list->value[newNode] = value;
+void dumpSvgCells(dumpBuffer_t *buffer, list_t *list, void (*nDump)(dumpBuffer_t *, list_t *, long long),
+                  const long long *cells, size_t count) {
+    const long long rowPitch = 2 * SVG_CELL_HEIGHT + 2 * SVG_MARGIN;
+    long long *columns = (long long *) calloc(count + 1, sizeof(long long));
+    long long column = 0;
 
-    if (temp != -1) {
-        list->next[temp] = newNode;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 ? cells[i] != cells[i - 1] + 1 : cells[i] != 0)
+            column++;
+        columns[i] = column++;
     }
+    if (count > 0 && cells[count - 1] != (long long) list->pool->capacity - 1)
+        column++;
+
+    bool contiguous = count == 0 || cells[count - 1] - cells[0] == (long long) count - 1;
+    long long rows = (column + SVG_ROW_CELLS - 1) / SVG_ROW_CELLS;
+    dumpSvgStart(buffer, 2 * SVG_MARGIN + std::min(column, (long long) SVG_ROW_CELLS) * SVG_CELL_WIDTH,
+                 2 * SVG_MARGIN + std::max(rows, 1ll) * rowPitch);
+
+    dumpBuffer_t scratch = {};
+    if (nDump)
+        initDumpBuffer(&scratch, nullptr, 256);
+
+    for (size_t i = 0; i <= count; i++) {
+        long long at = i < count ? columns[i] : column;
+
+        for (long long skipped = i == 0 ? 0 : columns[i - 1] + 1; skipped < at; skipped++) {
+            dumpString(buffer, "<text x=\"");
+            dumpInteger(buffer, SVG_MARGIN + skipped % SVG_ROW_CELLS * SVG_CELL_WIDTH + SVG_CELL_WIDTH / 2);
+            dumpString(buffer, "\" y=\"");
+            dumpInteger(buffer, SVG_MARGIN + skipped / SVG_ROW_CELLS * rowPitch + SVG_CELL_HEIGHT + 4);
+            dumpString(buffer, "\" text-anchor=\"middle\">...</text>\n");
+        }
 
-    list->tail = newNode;
-
-    if (list->head == -1) {
-        list->head = newNode;
+        if (i == count)
+            break;
+
+        long long x = SVG_MARGIN + at % SVG_ROW_CELLS * SVG_CELL_WIDTH;
+        long long y = SVG_MARGIN + at / SVG_ROW_CELLS * rowPitch;
+
+        dumpString(buffer, "<g id=\"node");
+        dumpInteger(buffer, cells[i]);
+        dumpString(buffer, "\" fill=\"");
+        dumpString(buffer, DUMP_SVG_COLORS[physicalCellKind(list, cells[i])]);
+        dumpString(buffer, "\" stroke=\"black\"><rect x=\"");
+        dumpInteger(buffer, x);
+        dumpString(buffer, "\" y=\"");
+        dumpInteger(buffer, y);
+        dumpString(buffer, "\" width=\"");
+        dumpInteger(buffer, SVG_CELL_WIDTH);
+        dumpString(buffer, "\" height=\"");
+        dumpInteger(buffer, 2 * SVG_CELL_HEIGHT);
+        dumpString(buffer, "\"/><text x=\"");
+        dumpInteger(buffer, x + SVG_CELL_WIDTH / 2);
+        dumpString(buffer, "\" y=\"");
+        dumpInteger(buffer, y + SVG_CELL_HEIGHT - 6);
+        dumpString(buffer, "\" text-anchor=\"middle\" fill=\"black\" stroke=\"none\">");
+        dumpInteger(buffer, cells[i]);
+        dumpString(buffer, "</text>");
+
+        if (nDump) {
+            dumpString(buffer, "<text x=\"");
+            dumpInteger(buffer, x + SVG_CELL_WIDTH / 2);
+            dumpString(buffer, "\" y=\"");
+            dumpInteger(buffer, y + 2 * SVG_CELL_HEIGHT - 6);
+            dumpString(buffer, "\" text-anchor=\"middle\" fill=\"black\" stroke=\"none\">");
+            dumpSvgText(buffer, &scratch, list, nDump, cells[i]);
+            dumpString(buffer, "</text>");
+        }
+        dumpString(buffer, "</g>\n");
     }
 
-    list->size++;
+    freeDumpBuffer(&scratch);
+
+    for (size_t i = 0; i < count; i++) {
+        long long from = columns[i];
+        bool occupied = isOccupied(list, cells[i]);
+        long long links[2] = {occupied && cells[i] != list->tail ? listNext(list, cells[i]) : -1,
+                              occupied && cells[i] == list->head ? -1 : listPrev(list, cells[i])};
+
+        for (int side = 0; side < 2; side++) {
+            long long link = links[side];
+            if (link < 0 || link >= (long long) list->pool->capacity || (!occupied && isOccupied(list, link)))
+                continue;
+
+            size_t index = 0;
+            if (contiguous) {
+                if (count == 0 || link < cells[0] || link > cells[count - 1])
+                    continue;
+                index = (size_t) (link - cells[0]);
+            } else {
+                const long long *found = std::lower_bound(cells, cells + count, link);
+                if (found == cells + count || *found != link)
+                    continue;
+                index = (size_t) (found - cells);
+            }
+
+            long long to = columns[index];
+            long long edge = side == 0 ? 0 : 2 * SVG_CELL_HEIGHT;
+
+            dumpSvgCurve(buffer, SVG_MARGIN + from % SVG_ROW_CELLS * SVG_CELL_WIDTH + SVG_CELL_WIDTH / 2 + (side ? 6 : -6),
+                         SVG_MARGIN + from / SVG_ROW_CELLS * rowPitch + edge,
+                         SVG_MARGIN + to % SVG_ROW_CELLS * SVG_CELL_WIDTH + SVG_CELL_WIDTH / 2 + (side ? 6 : -6),
+                         SVG_MARGIN + to / SVG_ROW_CELLS * rowPitch + edge, side == 0 ? -SVG_MARGIN : SVG_MARGIN,
+                         side == 0 ? "stroke=\"forestgreen\" marker-end=\"url(#arrow)\"" :
+                         occupied ? "stroke=\"firebrick\" marker-end=\"url(#arrow)\"" :
+                         "stroke=\"gray\" stroke-dasharray=\"4,3\" marker-end=\"url(#arrow)\"");
+        }
+    }
 
-    return 1;
+    dumpString(buffer, "</svg>\n");
+    free(columns);
 }
 
 /**
- * Function that inserts element after the given one
- * @param list Pointer to list_t
- * @param elem Physical number of element
- * @param value Void pointer to value
- * @return 0 if error occures, 1 otherwise
+ * Function that draws nodes of the list in logical order in SVG, SVG_ROW_CELLS nodes per row.
+ * Neighbours are joined by a double arrow, the last node of a row goes down to the next row
+ * @param buffer Pointer to dumpBuffer_t
+ * @param list Pointer to list
+ * @param nodeDump Optional function that renders value
+ */
+
+void dumpSvgChain(dumpBuffer_t *buffer, list_t *list, void (*nodeDump)(dumpBuffer_t *, list_t *, long long)) {
+    const long long columnPitch = SVG_CELL_WIDTH + SVG_MARGIN;
+    const long long rowPitch = 2 * SVG_CELL_HEIGHT + SVG_MARGIN;
+    long long rows = ((long long) list->size + SVG_ROW_CELLS - 1) / SVG_ROW_CELLS;
+
+    dumpSvgStart(buffer, SVG_MARGIN + std::min((long long) list->size, (long long) SVG_ROW_CELLS) * columnPitch,
+                 SVG_MARGIN + std::max(rows, 1ll) * rowPitch);
+
+    dumpBuffer_t scratch = {};
+    if (nodeDump)
+        initDumpBuffer(&scratch, nullptr, 256);
+
+    long long position = 0;
+
+    for (long long node = list->head; node != -1 && position < (long long) list->size; position++) {
+        long long x = SVG_MARGIN + position % SVG_ROW_CELLS * columnPitch;
+        long long y = SVG_MARGIN + position / SVG_ROW_CELLS * rowPitch;
+
+        if (node == list->head || node == list->tail) {
+            dumpString(buffer, "<text x=\"");
+            dumpInteger(buffer, x);
+            dumpString(buffer, "\" y=\"");
+            dumpInteger(buffer, y - 4);
+            dumpString(buffer, node == list->head ? "\">Head" : "\">Tail");
+            dumpString(buffer, node == list->head && node == list->tail ? ", Tail</text>\n" : "</text>\n");
+        }
+
+        dumpString(buffer, "<g id=\"node");
+        dumpInteger(buffer, node);
+        dumpString(buffer, "\"><rect x=\"");
+        dumpInteger(buffer, x);
+        dumpString(buffer, "\" y=\"");
+        dumpInteger(buffer, y);
+        dumpString(buffer, "\" width=\"");
+        dumpInteger(buffer, SVG_CELL_WIDTH);
+        dumpString(buffer, "\" height=\"");
+        dumpInteger(buffer, 2 * SVG_CELL_HEIGHT);
+        dumpString(buffer, "\" fill=\"");
+        dumpString(buffer, DUMP_SVG_COLORS[physicalCellKind(list, node)]);
+        dumpString(buffer, "\" stroke=\"black\"/><text x=\"");
+        dumpInteger(buffer, x + SVG_CELL_WIDTH / 2);
+        dumpString(buffer, "\" y=\"");
+        dumpInteger(buffer, y + SVG_CELL_HEIGHT - 6);
+        dumpString(buffer, "\" text-anchor=\"middle\">");
+        dumpInteger(buffer, node);
+        dumpString(buffer, "</text>");
+
+        if (nodeDump) {
+            dumpString(buffer, "<text x=\"");
+            dumpInteger(buffer, x + SVG_CELL_WIDTH / 2);
+            dumpString(buffer, "\" y=\"");
+            dumpInteger(buffer, y + 2 * SVG_CELL_HEIGHT - 6);
+            dumpString(buffer, "\" text-anchor=\"middle\">");
+            dumpSvgText(buffer, &scratch, list, nodeDump, node);
+            dumpString(buffer, "</text>");
+        }
+        dumpString(buffer, "</g>\n");
+
+        if (node == list->tail)
+            break;
+
+        dumpString(buffer, "<path d=\"M");
+        dumpInteger(buffer, x + SVG_CELL_WIDTH);
+        dumpString(buffer, ",");
+        dumpInteger(buffer, y + SVG_CELL_HEIGHT);
+        if ((position + 1) % SVG_ROW_CELLS) {
+            dumpString(buffer, "h");
+            dumpInteger(buffer, SVG_MARGIN);
+        } else {
+            dumpString(buffer, "h");
+            dumpInteger(buffer, SVG_MARGIN / 2);
+            dumpString(buffer, "v");
+            dumpInteger(buffer, SVG_CELL_HEIGHT + SVG_MARGIN / 2);
+            dumpString(buffer, "H");
+            dumpInteger(buffer, SVG_MARGIN / 2);
+            dumpString(buffer, "v");
+            dumpInteger(buffer, SVG_CELL_HEIGHT + SVG_MARGIN / 2);
+            dumpString(buffer, "h");
+            dumpInteger(buffer, SVG_MARGIN / 2);
+        }
+        dumpString(buffer, "\" fill=\"none\" stroke=\"black\" marker-start=\"url(#arrow)\" "
+                           "marker-end=\"url(#arrow)\"/>\n");
+
+        node = listNext(list, node);
+    }
+
+    freeDumpBuffer(&scratch);
+    dumpString(buffer, "</svg>\n");
+}
+
+/**
+ * Function that copies cells of the pool of the list into a new list with the same head, tail
+ * and size. Keys, jump index and modes are not copied
+ * @param list Pointer to list
+ * @return Pointer to the copy, nullptr if memory cannot be allocated
  */
 
-int insertAfter(list_t *list, long long elem, void *value) {
+list_t *copyListCells(list_t *list) {
     assert(list);
-    assert(elem >= 0);
 
-    if (list->size == list->maxsize)
-        return 0;
+    list_t *pool = list->pool;
+    list_t *copy = createList(pool->maxsize);
+    if (!copy)
+        return nullptr;
 
-    long long tmp = list->next[elem];
-    long long newNode = getEmpty(list);
+    size_t chunks = pool->chunks;
+    copy->occupied = (unsigned long long **) calloc(chunks + 1, sizeof(unsigned long long *));
 
-    list->prev[newNode] = elem;
-    list->next[newNode] = tmp;
-    list->value[newNode] = value;
+    bool copied = copy->occupied && growCellDirectories(copy, chunks + 1);
+    if (copied)
+        copy->directorySize = chunks + 1;
 
-    list->next[elem] = newNode;
+    for (size_t i = 0; copied && i < chunks; i++) {
+        size_t cells = std::min(pool->capacity - i * LIST_CHUNK_SIZE, LIST_CHUNK_SIZE);
 
-    if (tmp != -1) {
-        list->prev[tmp] = newNode;
-    } else {
-        list->tail = newNode;
+        copy->occupied[i] = (unsigned long long *) malloc(LIST_CHUNK_SIZE / 64 * sizeof(unsigned long long));
+        copy->chunks = i + 1;
+
+        copied = allocateCellChunk(copy, i, cells) && copy->occupied[i];
+        if (copied) {
+            copyCellChunk(copy, pool, i, cells);
+            memcpy(copy->occupied[i], pool->occupied[i], LIST_CHUNK_SIZE / 64 * sizeof(unsigned long long));
+        }
     }
 
-    list->size++;
+    if (!copied) {
+        deleteList(&copy);
+        return nullptr;
+    }
 
-    return 1;
+    copy->capacity = pool->capacity;
+    copy->emptyHead = pool->emptyHead;
+    copy->head = list->head;
+    copy->tail = list->tail;
+    copy->size = list->size;
+    copy->linearPrefix = list->linearPrefix;
+
+    return copy;
 }
 
 /**
- * Function that inserts element before the given one
- * @param list Pointer to list_t
- * @param elem Physical number of element
- * @param value Void pointer to value
- * @return 0 if error occures, 1 otherwise
+ * Function that copies cells of the list and starts a thread which dumps the copy
+ * @param list Pointer to list
+ * @param dumpFilename Dump filename
+ * @param nodeDump Node value dumper, gets the copy of the list
+ * @param options Options of the dump or nullptr
+ * @param physical True for listPhysicalDump, False for dumpList
+ * @return Future with the result of the dump
  */
 
-int insertBefore(list_t *list, long long elem, void *value) {
+std::future<int> startAsyncDump(list_t *list, const char *dumpFilename,
+                                void (*nodeDump)(dumpBuffer_t *, list_t *, long long), const dumpOptions_t *options,
+                                bool physical) {
     assert(list);
-    assert(elem >= 0);
+    assert(dumpFilename);
 
-    if (list->size == list->maxsize)
-        return 0;
+    std::promise<int> result;
+    std::future<int> future = result.get_future();
+    list_t *copy = copyListCells(list);
+    char *path = strdup(dumpFilename);
+
+    if (!copy || !path) {
+        if (copy)
+            deleteList(&copy);
+        free(path);
+        result.set_value(0);
+        return future;
+    }
 
-    long long tmp = list->prev[elem];
-    long long newNode = getEmpty(list);
+    dumpOptions_t copiedOptions = options ? *options : DUMP_ALL;
+    bool hasOptions = options != nullptr;
 
-    list->next[newNode] = elem;
-    list->prev[newNode] = tmp;
-    list->value[newNode] = value;
+    std::thread([copy, path, nodeDump, copiedOptions, hasOptions, physical](std::promise<int> result) mutable {
+        int written = physical ? listPhysicalDump(copy, path, nodeDump, hasOptions ? &copiedOptions : nullptr)
+                               : dumpList(copy, path, nodeDump, hasOptions ? &copiedOptions : nullptr);
 
-    list->prev[elem] = newNode;
+        copy->head = -1; // Nodes of the copy are freed with its chunks, there is no need to unlink them
+        deleteList(&copy);
+        free(path);
+        result.set_value(written);
+    }, std::move(result)).detach();
 
-    if (tmp != -1) {
-        list->next[tmp] = newNode;
-    } else {
-        list->head = newNode;
-    }
+    return future;
+}
 
-    list->size++;
+/**
+ * Function that dumps list in the background. Cells are copied before it returns, so the list
+ * can be changed right away, but values which nodeDump dereferences must stay valid until the
+ * dump is written. Future must be waited for before the program exits
+ * @param list Pointer to list
+ * @param dumpFilename Dump filename
+ * @param nodeDump Optional function that renders value into the buffer
+ * @param options Optional pointer to dumpOptions_t, it is copied
+ * @return Future with 0 if error occures, 1 otherwise
+ */
 
-    return 1;
+std::future<int> dumpListAsync(list_t *list, const char *dumpFilename,
+                               void (*nodeDump)(dumpBuffer_t *, list_t *, long long), const dumpOptions_t *options) {
+    return startAsyncDump(list, dumpFilename, nodeDump, options, false);
 }
 
 /**
- * Function that gets the first element of the list
- * @param list Poiter to list_t
- * @return Physical number of element
+ * Function that makes physical dump in the background like dumpListAsync does
+ * @param list Pointer to list
+ * @param dumpFilename Dump filename
+ * @param nodeDump Node value dumper, may be nullptr for JSON Lines and binary formats
+ * @param options Optional pointer to dumpOptions_t, it is copied
+ * @return Future with 0 if error occures, 1 otherwise
  */
 
-long long getFirstElement(list_t *list) {
-    assert(list);
-
-    return list->head;
+std::future<int> listPhysicalDumpAsync(list_t *list, const char *dumpFilename,
+                                       void (*nodeDump)(dumpBuffer_t *, list_t *, long long),
+                                       const dumpOptions_t *options) {
+    return startAsyncDump(list, dumpFilename, nodeDump, options, true);
 }
 
 /**
- * Function that gets the last element of the list
- * @param list Poiter to list_t
- * @return Physical number of element
+ * Function that writes bytes to the snapshot through its buffer
+ * @param writer Pointer to snapshotWriter_t
+ * @param data Bytes
+ * @param n Number of bytes
  */
 
-long long getLastElement(list_t *list) {
-    assert(list);
+void writeSnapshotBytes(snapshotWriter_t *writer, const void *data, size_t n) {
+    if (writer->used + n > SNAPSHOT_BUFFER_SIZE) {
+        flushSnapshot(writer);
 
-    return list->tail;
+        if (n > SNAPSHOT_BUFFER_SIZE) {
+            writer->failed = writer->failed || fwrite(data, 1, n, writer->file) != n;
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, data, n);
+    writer->used += n;
 }
 
 /**
- * Function that gets element after the given one
- * @param list Poiter to list_t
- * @param node Physical adress of element
- * @return Physical number of element
+ * Function that writes number in LEB128 varint encoding, 7 bits per byte starting from the lowest
+ * @param writer Pointer to snapshotWriter_t
+ * @param number Number
  */
 
-long long getNextElement(list_t *list, long long node) {
-    assert(list);
-    assert(node >= 0);
+void writeVarint(snapshotWriter_t *writer, unsigned long long number) {
+    if (writer->used + 10 > SNAPSHOT_BUFFER_SIZE)
+        flushSnapshot(writer);
 
-    return list->next[node];
+    while (number >= 0x80) {
+        writer->buffer[writer->used++] = (unsigned char) (number | 0x80);
+        number >>= 7;
+    }
+    writer->buffer[writer->used++] = (unsigned char) number;
 }
 
 /**
- * Function that gets element before the given one
- * @param list Pointer to list_t
- * @param node Physical address of element
- * @return Physical number of element
+ * Function that writes buffered bytes to the file
+ * @param writer Pointer to snapshotWriter_t
  */
 
-long long getPreviousElement(list_t *list, long long node) {
-    assert(list);
-    assert(node >= 0);
-
-    return list->prev[node];
+void flushSnapshot(snapshotWriter_t *writer) {
+    writer->failed = writer->failed || fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used;
+    writer->used = 0;
 }
 
 /**
- * Function that returns physical address by logical adress
- * @param list Pointer to list_t
- * @param position Logical position
- * @return Physical position
+ * Function that returns pointer to the next n bytes of the snapshot. Bytes which do not fit
+ * into the rest of the buffer are copied to the scratch memory of the reader
+ * @param reader Pointer to snapshotReader_t
+ * @param n Number of bytes
+ * @return Pointer to bytes valid until the next read, nullptr if the file ends earlier
  */
 
-long long getElementByPosition(list_t *list, size_t position) {
-    assert(list);
+const unsigned char *readSnapshotBytes(snapshotReader_t *reader, size_t n) {
+    if (reader->filled - reader->used >= n) {
+        reader->used += n;
+        return reader->buffer + reader->used - n;
+    }
 
-    if (position >= list->size)
-        return -1;
+    if (reader->scratchSize < n) {
+        unsigned char *scratch = (unsigned char *) realloc(reader->scratch, n);
+        if (!scratch)
+            return nullptr;
+        reader->scratch = scratch;
+        reader->scratchSize = n;
+    }
 
-    long long curNode = list->head;
+    size_t copied = reader->filled - reader->used;
+    memcpy(reader->scratch, reader->buffer + reader->used, copied);
+    reader->used = reader->filled = 0;
 
-    for (size_t i = 0; i < position; i++) {
-        if (curNode == -1)
-            return curNode;
-        curNode = list->next[curNode];
+    if (n - copied > SNAPSHOT_BUFFER_SIZE / 2) {
+        if (fread(reader->scratch + copied, 1, n - copied, reader->file) != n - copied)
+            return nullptr;
+        return reader->scratch;
     }
 
-    return curNode;
+    reader->filled = fread(reader->buffer, 1, SNAPSHOT_BUFFER_SIZE, reader->file);
+    if (reader->filled < n - copied)
+        return nullptr;
+
+    memcpy(reader->scratch + copied, reader->buffer, n - copied);
+    reader->used = n - copied;
+    return reader->scratch;
 }
 
 /**
- * Function that finds first occurance of the value
- * @param list Pointer to list_t
- * @param value Void to pointer value
- * @param cmp Pointer to comparator
- * @return Physical address of the element
+ * Function that reads number in LEB128 varint encoding
+ * @param reader Pointer to snapshotReader_t
+ * @param number Place for the number
+ * @return False if the file ends earlier or the number is longer than 64 bits, True otherwise
  */
 
-long long findFirstNode(list_t *list, void *value, bool (*cmp)(void *, void *)) {
-    assert(list);
+bool readVarint(snapshotReader_t *reader, unsigned long long *number) {
+    *number = 0;
 
-    long long node = list->head;
+    if (reader->filled - reader->used >= 10) {
+        const unsigned char *bytes = reader->buffer + reader->used;
 
-    for (size_t i = 0; i < list->size; i++) {
-        if (node == -1)
-            return -1;
+        for (unsigned i = 0; i < 10; i++) {
+            *number |= (unsigned long long) (bytes[i] & 0x7f) << (7 * i);
+            if (!(bytes[i] & 0x80)) {
+                reader->used += i + 1;
+                return true;
+            }
+        }
 
-        if (cmp(list->value[node], value))
-            return node;
+        return false;
+    }
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const unsigned char *byte = readSnapshotBytes(reader, 1);
+        if (!byte)
+            return false;
 
-        node = list->next[node];
+        *number |= (unsigned long long) (*byte & 0x7f) << shift;
+        if (!(*byte & 0x80))
+            return true;
     }
 
-    return -1;
+    return false;
 }
 
 /**
- * Function that finds last occurance of the value
+ * Function that saves list to a binary snapshot in logical order. Without serializer values are
+ * handles, i. e. integers cast to void *, and are stored as zigzag varint deltas of consecutive
+ * values. With serializer each value is stored as varint length and the bytes it returns
  * @param list Pointer to list_t
- * @param value Void to pointer value
- * @param cmp Pointer to comparator
- * @return Physical address of the element
+ * @param path Path to the snapshot
+ * @param serialize Function that gets value and arg, returns pointer to the bytes of value and
+ * puts their number to size, the bytes must stay valid until the next call. nullptr for handles
+ * @param arg Argument for serialize
+ * @return 0 if error occures, 1 otherwise
  */
 
-long long findLastNode(list_t *list, void *value, bool (*cmp)(void *, void *)) {
+int saveList(list_t *list, const char *path, const void *(*serialize)(void *, size_t *, void *), void *arg) {
     assert(list);
+    assert(path);
 
-    long long node = list->tail;
+    snapshotWriter_t *writer = (snapshotWriter_t *) calloc(1, sizeof(snapshotWriter_t));
+    if (!writer)
+        return 0;
 
-    for (size_t i = list->size - 1; i >= 0; i--) {
-        if (node == -1)
-            return -1;
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        free(writer);
+        return 0;
+    }
 
-        if (cmp(list->value[node], value))
-            return node;
+    unsigned char flags = serialize ? 0 : SNAPSHOT_HANDLES;
+
+    writeSnapshotBytes(writer, LIST_SNAPSHOT_MAGIC, sizeof(LIST_SNAPSHOT_MAGIC));
+    writeSnapshotBytes(writer, &LIST_SNAPSHOT_VERSION, 1);
+    writeSnapshotBytes(writer, &flags, 1);
+    writeVarint(writer, list->maxsize == LIST_UNBOUNDED ? 0 : list->maxsize);
+    writeVarint(writer, list->size);
+
+    unsigned long long previous = 0;
+
+    for (long long node = list->head; node != -1; node = listNext(list, node)) {
+        void *value = listValue(list, node);
+
+        if (serialize) {
+            size_t size = 0;
+            const void *bytes = serialize(value, &size, arg);
+
+            writeVarint(writer, size);
+            writeSnapshotBytes(writer, bytes, size);
+        } else {
+            unsigned long long delta = (unsigned long long) (uintptr_t) value - previous;
 
-        node = list->prev[node];
+            writeVarint(writer, (delta << 1) ^ (unsigned long long) ((long long) delta >> 63));
+            previous = (uintptr_t) value;
+        }
     }
 
-    return -1;
+    flushSnapshot(writer);
+
+    int saved = !writer->failed;
+    saved = (fclose(writer->file) == 0) && saved;
+    free(writer);
+
+    return saved;
 }
 
 /**
- * Function that deletes node
- * @param list Pointer to list_t
- * @param node Physical adress of the node
+ * Function that loads list from a snapshot written by saveList. Values are appended in batches
+ * to a new list, so it comes out fully linearized in one sequential pass over the file
+ * @param path Path to the snapshot
+ * @param deserialize Function that gets bytes of value, their number and arg and returns value.
+ * nullptr if the snapshot stores handles
+ * @param arg Argument for deserialize
+ * @return Pointer to list_t, nullptr if the file cannot be read or is not a snapshot of this kind
  */
 
-void deleteNode(list_t *list, long long node) {
-    assert(list);
-    assert(node >= 0);
-    assert(node < list->size);
+list_t *loadList(const char *path, void *(*deserialize)(const void *, size_t, void *), void *arg) {
+    assert(path);
 
-    if (list->prev[node] != -1)
-        list->next[list->prev[node]] = list->next[node];
-    else
-        list->head = list->next[node];
+    snapshotReader_t *reader = (snapshotReader_t *) calloc(1, sizeof(snapshotReader_t));
+    void **batch = (void **) calloc(LIST_CHUNK_SIZE, sizeof(void *));
+    list_t *list = nullptr;
 
-    if (list->next[node] != -1)
-        list->prev[list->next[node]] = list->prev[node];
-    else
-        list->tail = list->prev[node];
+    if (!reader || !batch || !(reader->file = fopen(path, "rb"))) {
+        free(reader);
+        free(batch);
+        return nullptr;
+    }
 
-    list->next[node] = -1;
-    list->value[node] = nullptr;
-    list->size--;
-    // stackPush(&list->free, node);
-    addEmpty(list, node);
-}
+    const unsigned char *header = readSnapshotBytes(reader, sizeof(LIST_SNAPSHOT_MAGIC) + 2);
+    unsigned long long maxsize = 0;
+    unsigned long long size = 0;
+    bool loaded = header && memcmp(header, LIST_SNAPSHOT_MAGIC, sizeof(LIST_SNAPSHOT_MAGIC)) == 0 &&
+                  header[sizeof(LIST_SNAPSHOT_MAGIC)] == LIST_SNAPSHOT_VERSION;
 
-/**
- * Function that validates the list
- * @param list Pointer to list_t
- * @return List Validity value
- */
+    if (loaded) {
+        bool handles = header[sizeof(LIST_SNAPSHOT_MAGIC) + 1] & SNAPSHOT_HANDLES;
+        loaded = (handles == !deserialize) && readVarint(reader, &maxsize) && readVarint(reader, &size) &&
+                 (maxsize == 0 || size <= maxsize);
+    }
 
-listValidity validateList(list_t *list) {
-    if (!list)
-        return LIST_NOT_FOUND;
+    if (loaded) {
+        list = createList(maxsize ? maxsize : LIST_UNBOUNDED);
+        loaded = list != nullptr;
+    }
 
-    size_t size = list->size;
-    long long node = list->head;
+    unsigned long long previous = 0;
 
-    for (size_t i = 0; i < size - 1; i++) {
-        if (node == -1)
-            return CORRUPTED;
+    for (unsigned long long done = 0; loaded && done < size;) {
+        size_t count = std::min((unsigned long long) LIST_CHUNK_SIZE, size - done);
+
+        for (size_t i = 0; loaded && i < count; i++) {
+            unsigned long long number = 0;
+            loaded = readVarint(reader, &number);
+
+            if (!loaded)
+                break;
+
+            if (deserialize) {
+                const unsigned char *bytes = readSnapshotBytes(reader, number);
+                loaded = bytes != nullptr;
+                if (loaded)
+                    batch[i] = deserialize(bytes, number, arg);
+            } else {
+                previous += (number >> 1) ^ (~(number & 1) + 1);
+                batch[i] = (void *) (uintptr_t) previous;
+            }
+        }
 
-        node = list->next[node];
+        loaded = loaded && appendRange(list, batch, count);
+        done += count;
     }
 
-    if (list->tail != node)
-        return CORRUPTED;
+    if (!loaded && list)
+        deleteList(&list);
 
-    return OK;
+    fclose(reader->file);
+    free(reader->scratch);
+    free(reader);
+    free(batch);
+
+    return list;
 }
 
 /**
- * Function that dumps list
- * @param list Pointer to list
- * @param dumpFilename Dump filename
- * @param nodeDump Optional function that renders value
+ * Function that sorts list, i. e. places elements in cells in their logical order.
+ * List must own its cells, must not share them and must not have concurrent slots enabled
+ * @param list
  */
 
-void dumpList(list_t *list, const char *dumpFilename, char *(*nodeDump)(list_t *, long long)) {
+void sortList(list_t *list) {
     assert(list);
-    assert(dumpFilename);
-
-    FILE *dumpFile = fopen(dumpFilename, "w");
-    fprintf(dumpFile, "digraph {\n");
+    assert(list->pool == list && list->sharers == 0 && !list->slots);
 
+    void **values = (void **) calloc(list->size + 1, sizeof(void *));
+    long long *keys = list->keys ? (long long *) calloc(list->size + 1, sizeof(long long)) : nullptr;
+    bool *keyed = list->keys ? (bool *) calloc(list->size + 1, sizeof(bool)) : nullptr;
     long long node = list->head;
 
-    fprintf(dumpFile, "node%lld[label=\"{{%lld}", node, node);
-    if (nodeDump) {
-        fprintf(dumpFile, "|{%s}", (*nodeDump)(list, node));
+    for (size_t i = 0; i < list->size; i++) {
+        values[i] = listValue(list, node);
+
+        if (keys && hasNodeKey(list, node)) {
+            keys[i] = getNodeKey(list, node);
+            keyed[i] = true;
+        }
+
+        node = listNext(list, node);
     }
-    fprintf(dumpFile, "}\",shape=record];\n");
 
-    while (node != list->tail) {
-        fprintf(dumpFile, "node%lld[label=\"{{%lld}", list->next[node], list->next[node]);
-        if (nodeDump) {
-            fprintf(dumpFile, "|{%s}", (*nodeDump)(list, list->next[node]));
+    for (long long i = 0; i < (long long) list->size; i++) {
+        listValue(list, i) = values[i];
+        listNext(list, i) = i + 1;
+        listPrev(list, i) = i - 1;
+
+        if (keys) {
+            if (keyed[i])
+                setNodeKey(list, i, keys[i]);
+            else
+                clearNodeKey(list, i);
         }
-        fprintf(dumpFile, "}\",shape=record];\n");
+    }
+
+    free(values);
+    free(keys);
+    free(keyed);
+    resetOccupancy(list, list->size);
 
-        fprintf(dumpFile, "node%lld -> node%lld;\n", node, list->next[node]);
-        fprintf(dumpFile, "node%lld -> node%lld;\n", list->next[node], node);
-        node = list->next[node];
+    list->emptyHead = -1;
+    list->freeCells = 0;
+
+    for (long long i = list->capacity - 1; i >= (long long) list->size; i--) {
+        listValue(list, i) = nullptr;
+        listNext(list, i) = -1;
+        addEmpty(list, i);
     }
 
-    fprintf(dumpFile, "Head -> node%lld;\n", list->head);
-    fprintf(dumpFile, "node%lld -> Tail;\n", list->tail);
-    fprintf(dumpFile, "}");
-    fclose(dumpFile);
+    if (list->size == 0) {
+        list->head = -1;
+        list->tail = -1;
+        list->linearPrefix = 0;
+        return;
+    }
+
+    list->head = 0;
+    list->tail = list->size - 1;
+    listNext(list, list->tail) = -1;
+    listPrev(list, list->head) = -1;
+    list->linearPrefix = list->size;
+
+    invalidateJumpIndex(list);
 }
 
 /**
- * Physical dump of memory
- * @param list Pointer to list
- * @param dumpFilename Where to saveDump
- * @param nDump Node value dumper
+ * Function that sorts list by values with stable bottom-up merge sort.
+ * Only links are changed, values stay in their cells and no extra memory is used
+ * @param list Pointer to list_t
+ * @param cmp Comparator that returns negative, zero or positive number like for qsort
  */
 
-void listPhysicalDump(list_t *list, const char *dumpFilename, char *(*nDump)(list_t *, long long)) {
+void sortListBy(list_t *list, int (*cmp)(void *, void *)) {
     assert(list);
-    assert(dumpFilename);
+    assert(cmp);
+
+    if (list->size < 2)
+        return;
+
+    long long head = list->head;
+
+    for (size_t width = 1;; width *= 2) {
+        long long left = head;
+        long long tail = -1;
+        size_t merges = 0;
+
+        head = -1;
+
+        while (left != -1) {
+            long long right = left;
+            size_t leftSize = 0;
+            size_t rightSize = width;
+
+            merges++;
+
+            while (leftSize < width && right != -1) {
+                leftSize++;
+                right = listNext(list, right);
+            }
+
+            while (leftSize > 0 || (rightSize > 0 && right != -1)) {
+                long long node = -1;
+
+                if (leftSize > 0 && (rightSize == 0 || right == -1 ||
+                                     cmp(listValue(list, left), listValue(list, right)) <= 0)) {
+                    node = left;
+                    left = listNext(list, left);
+                    leftSize--;
+                } else {
+                    node = right;
+                    right = listNext(list, right);
+                    rightSize--;
+                }
+
+                if (tail != -1)
+                    listNext(list, tail) = node;
+                else
+                    head = node;
+                tail = node;
+            }
+
+            left = right;
+        }
 
-    FILE *dumpFile = fopen(dumpFilename, "w");
-    fprintf(dumpFile, "digraph {\n");
+        listNext(list, tail) = -1;
 
-    fprintf(dumpFile, "mainNode[shape=none,\nlabel = <<table><tr>");
+        if (merges <= 1)
+            break;
+    }
 
+    long long prev = -1;
+    bool ordered = true;
 
-    for (long long i = 0; i < list->maxsize; i++) {
-        fprintf(dumpFile, "<td port=\"node%lldnext\" border=\"1\" bgcolor=\"", i);
+    list->linearPrefix = 0;
 
-        if (i == list->head) {
-            fprintf(dumpFile, "cadetblue");
-        } else if (i == list->tail) {
-            fprintf(dumpFile, "darkgoldenrod1");
-        } else if (list->next[i] == -1) {
-            fprintf(dumpFile, "indianred1");
-        } else {
-            fprintf(dumpFile, "seagreen1");
-        }
+    for (long long node = head; node != -1; node = listNext(list, node)) {
+        listPrev(list, node) = prev;
+
+        if (ordered && node == (long long) list->linearPrefix)
+            list->linearPrefix++;
+        else
+            ordered = false;
 
-        fprintf(dumpFile, "\">%lld</td>\n", i);
+        prev = node;
     }
-    fprintf(dumpFile, "</tr>\n<tr>\n");
 
-    for (long long i = 0; i < list->maxsize; i++) {
-        fprintf(dumpFile, "<td port=\"node%lldprev\" border=\"1\" bgcolor=\"", i);
+    list->head = head;
+    list->tail = prev;
+    invalidateJumpIndex(list);
+}
 
-        if (i == list->head) {
-            fprintf(dumpFile, "cadetblue");
-        } else if (i == list->tail) {
-            fprintf(dumpFile, "darkgoldenrod1");
-        } else if (list->next[i] == -1) {
-            fprintf(dumpFile, "indianred1");
-        } else {
-            fprintf(dumpFile, "seagreen1");
-        }
+/**
+ * Function that runs job(thread, begin, end) for equal slices of [0, n) on separate threads
+ * @param threads Number of threads
+ * @param n Size of range
+ * @param job Function to run
+ */
 
-        fprintf(dumpFile, "\">%s</td>\n", nDump(list, i));
-    }
+template<typename Job>
+void runSlices(unsigned threads, size_t n, Job job) {
+    std::vector<std::thread> workers;
 
-    fprintf(dumpFile, "</tr></table>>\n];\n");
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(job, i, n * i / threads, n * (i + 1) / threads);
 
-    long long node = list->head;
+    job(0, 0, n / threads);
 
-    while (node != list->tail) {
-        fprintf(dumpFile, "mainNode:node%lldnext:n -> mainNode:node%lldnext:n [color=\"forestgreen\"];\n", node,
-                list->next[node]);
+    for (std::thread &worker : workers)
+        worker.join();
+}
 
-        node = list->next[node];
-    }
+/**
+ * Function that stably sorts array on several threads: slices are sorted separately and then
+ * merged pairwise, ping-ponging between values and buffer
+ * @param values Array to sort
+ * @param buffer Scratch array of the same size
+ * @param size Number of elements
+ * @param threads Number of threads
+ * @param less Strict weak ordering of elements
+ * @return Pointer to whichever of values and buffer holds the sorted elements
+ */
 
-    node = list->tail;
+template<typename T, typename Less>
+T *parallelStableSort(T *values, T *buffer, size_t size, unsigned threads, Less less) {
+    std::vector<size_t> bounds;
 
-    while (node != list->head) {
-        fprintf(dumpFile, "mainNode:node%lldprev:s -> mainNode:node%lldprev:s [color=\"firebrick\"];\n", node,
-                list->prev[node]);
+    for (unsigned i = 0; i <= threads; i++)
+        bounds.push_back(size * i / threads);
 
-        node = list->prev[node];
-    }
+    runSlices(threads, size, [&](unsigned, size_t begin, size_t end) {
+        std::stable_sort(values + begin, values + end, less);
+    });
+
+    while (bounds.size() > 2) {
+        std::vector<size_t> merged;
+        std::vector<std::thread> workers;
 
-    if (list->emptyHead != -1) {
-        long long empty = list->emptyHead;
-        fprintf(dumpFile, "{rank=same;\nempty%lld [label=\"%lld\", shape=box];\n", empty, empty);
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
 
-        while (list->prev[empty] != -1) {
-            fprintf(dumpFile, "empty%lld [label=\"%lld\", shape=box];\n", list->prev[empty], list->prev[empty]);
-            fprintf(dumpFile, "empty%lld -> empty%lld;\n", empty, list->prev[empty]);
-            empty = list->prev[empty];
+            if (i + 2 < bounds.size()) {
+                workers.emplace_back([=]() {
+                    std::merge(values + bounds[i], values + bounds[i + 1], values + bounds[i + 1],
+                               values + bounds[i + 2], buffer + bounds[i], less);
+                });
+            } else {
+                std::copy(values + bounds[i], values + bounds[i + 1], buffer + bounds[i]);
+            }
         }
-        fprintf(dumpFile, "}\n;");
+        merged.push_back(size);
+
+        for (std::thread &worker : workers)
+            worker.join();
+
+        std::swap(values, buffer);
+        bounds = merged;
     }
 
-    fprintf(dumpFile, "}");
-    fclose(dumpFile);
+    return values;
 }
 
 /**
- * Function that sorts list
- * @param list
+ * Value of a cell together with its inline key, moved as a whole by sortListParallel
  */
 
-void sortList(list_t *list) {
+struct keyedValue_t {
+    void *value;
+    long long key;
+    bool keyed;
+};
+
+/**
+ * Function that sorts list by values on several threads. Values are gathered in logical
+ * order, sorted in slices which are then merged pairwise, and written back in parallel
+ * together with links, so the list ends up sorted as well as linearized like after sortList.
+ * Inline keys, if enabled, travel with their values.
+ * List must own its cells, must not share them and must not have concurrent slots enabled
+ * @param list Pointer to list_t
+ * @param cmp Comparator that returns negative, zero or positive number like for qsort
+ * @param threads Number of threads, 0 to use all cores
+ */
+
+void sortListParallel(list_t *list, int (*cmp)(void *, void *), unsigned threads) {
     assert(list);
-    long long node = list->head;
-    void *swapValue = nullptr;
-    long long swapPos = 0;
-    long long nextNode = 0;
-    long long pos = 0;
+    assert(cmp);
+    assert(list->pool == list && list->sharers == 0 && !list->slots);
 
-    while (node != list->tail) {
-        swapValue = list->value[pos];
-        list->value[pos] = list->value[node];
-        list->value[node] = swapValue;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
 
-        nextNode = list->next[node];
+    size_t size = list->size;
+    void **values = (void **) calloc(size + 1, sizeof(void *));
+    void **buffer = nullptr;
+    keyedValue_t *cells = nullptr;
+    keyedValue_t *cellBuffer = nullptr;
+    void **sortedValues = values;
+    long long node = list->head;
 
-        if (list->next[pos] != -1) {
-            list->next[node] = list->next[pos];
+    if (list->keys) {
+        cells = (keyedValue_t *) calloc(size + 1, sizeof(keyedValue_t));
+        cellBuffer = (keyedValue_t *) calloc(size + 1, sizeof(keyedValue_t));
+
+        for (size_t i = 0; i < size; i++) {
+            bool keyed = hasNodeKey(list, node);
+            cells[i] = {listValue(list, node), keyed ? getNodeKey(list, node) : 0, keyed};
+            node = listNext(list, node);
         }
 
-        node = nextNode;
+        keyedValue_t *sorted = parallelStableSort(cells, cellBuffer, size, threads,
+                                                  [cmp](const keyedValue_t &first, const keyedValue_t &second) {
+                                                      return cmp(first.value, second.value) < 0;
+                                                  });
 
-        pos++;
-    }
+        for (size_t i = 0; i < size; i++)
+            values[i] = sorted[i].value;
 
-    list->prev[list->maxsize - 1] = -1;
-    list->next[list->maxsize - 1] = -1;
+        if (sorted != cells)
+            std::swap(cells, cellBuffer);
+    } else {
+        buffer = (void **) calloc(size + 1, sizeof(void *));
 
-    list->emptyHead = list->maxsize - 1;
+        for (size_t i = 0; i < size; i++) {
+            values[i] = listValue(list, node);
+            node = listNext(list, node);
+        }
 
-    for (long long i = list->maxsize - 2; i >= list->size; i--) {
-        addEmpty(list, i);
-        list->next[i] = -1;
+        sortedValues = parallelStableSort(values, buffer, size, threads, [cmp](void *first, void *second) {
+            return cmp(first, second) < 0;
+        });
     }
 
-    for (int i = 0; i < list->size; i++) {
-        if (i > 0)
-            list->next[i - 1] = i;
-        if (i < list->size - 1)
-            list->prev[i + 1] = i;
+    long long capacity = list->capacity;
+
+    runSlices(threads, capacity, [&](unsigned, size_t begin, size_t end) {
+        for (long long i = begin; i < (long long) end; i++) {
+            if (i < (long long) size) {
+                listValue(list, i) = sortedValues[i];
+                listNext(list, i) = (i + 1 < (long long) size) ? i + 1 : -1;
+                listPrev(list, i) = i - 1;
+            } else {
+                listValue(list, i) = nullptr;
+                listNext(list, i) = -1;
+                listPrev(list, i) = (i + 1 < capacity) ? i + 1 : -1;
+            }
+        }
+    });
+
+    if (cells) {
+        // Keyed bits of neighbouring cells share words, so keys are written back on one thread
+        for (long long i = 0; i < capacity; i++) {
+            if (i < (long long) size && cells[i].keyed)
+                setNodeKey(list, i, cells[i].key);
+            else
+                clearNodeKey(list, i);
+        }
     }
-    list->head = 0;
-    list->tail = list->size - 1;
-    list->next[list->tail] = -1;
-    list->prev[list->head] = -1;
 
+    free(values);
+    free(buffer);
+    free(cells);
+    free(cellBuffer);
+    resetOccupancy(list, size);
+
+    list->head = size ? 0 : -1;
+    list->tail = size ? (long long) size - 1 : -1;
+    list->emptyHead = (capacity > (long long) size) ? (long long) size : -1;
+    list->freeCells = capacity - size;
+    list->linearPrefix = size;
+    invalidateJumpIndex(list);
 }
 
 /**
@@ -783,14 +8227,14 @@ bool verifyList(list_t *list) {
         if (node == -1)
             return false;
 
-        if(list->prev[list->next[node]] != node)
+        if(listPrev(list, listNext(list, node)) != node)
             return false;
 
-        node = list->next[node];
+        node = listNext(list, node);
     }
 
     if(node != list->head)
         return false;
 
     return true;
-}
\ No newline at end of file
+}
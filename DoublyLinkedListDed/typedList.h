@@ -0,0 +1,598 @@
+#ifndef DOUBLYLINKEDLISTDED_TYPEDLIST_H
+#define DOUBLYLINKEDLISTDED_TYPEDLIST_H
+
+#include <cstdlib>
+#include <cassert>
+#include <utility>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+enum listValidity {
+    OK = 0,
+    LIST_NOT_FOUND = 1,
+    CORRUPTED = 2
+};
+
+/**
+ * Links are stored biased by one in an unsigned or signed integer of type Index, so
+ * that -1 (no element) is stored as 0 for every index width. Narrow indices shrink
+ * link memory and fit more links into a cache line
+ */
+
+template<typename Index>
+long long loadIndex(Index stored) {
+    return (long long) stored - 1;
+}
+
+template<typename Index>
+Index storeIndex(long long index) {
+    return (Index) (index + 1);
+}
+
+/**
+ * Maximal number of cells that can be addressed with Index, one code is kept spare
+ * @tparam Index Index type
+ * @return Maximal maxsize
+ */
+
+template<typename Index>
+size_t maxCellsFor() {
+    return (size_t) std::numeric_limits<Index>::max() - 1;
+}
+
+/**
+ * Picks the narrowest index type able to address MAXSIZE cells
+ */
+
+template<size_t MAXSIZE>
+struct listIndexFor {
+    typedef typename std::conditional<(MAXSIZE < 0xFFFFull), uint16_t,
+            typename std::conditional<(MAXSIZE < 0xFFFFFFFFull), uint32_t, long long>::type>::type type;
+};
+
+/**
+ * Structure-of-arrays layout: values and links are kept in three separate arrays
+ */
+
+template<typename T, typename Index = long long>
+struct soaLayout {
+    typedef Index index_t;
+
+    T *values;
+    Index *nexts;
+    Index *prevs;
+
+    void allocate(size_t maxsize) {
+        values = new T[maxsize]();
+        nexts = (Index *) calloc(maxsize, sizeof(Index));
+        prevs = (Index *) calloc(maxsize, sizeof(Index));
+    }
+
+    void release() {
+        delete[] values;
+        free(nexts);
+        free(prevs);
+    }
+
+    T &value(long long node) { return values[node]; }
+
+    long long next(long long node) const { return loadIndex(nexts[node]); }
+
+    long long prev(long long node) const { return loadIndex(prevs[node]); }
+
+    void setNext(long long node, long long link) { nexts[node] = storeIndex<Index>(link); }
+
+    void setPrev(long long node, long long link) { prevs[node] = storeIndex<Index>(link); }
+};
+
+/**
+ * Array-of-structures layout: {next, prev, value} of a cell are packed into one record,
+ * so touching a cell costs one cache line instead of three
+ */
+
+template<typename T, typename Index = long long>
+struct aosLayout {
+    typedef Index index_t;
+
+    struct cell_t {
+        Index next;
+        Index prev;
+        T value;
+    };
+
+    cell_t *cells;
+
+    void allocate(size_t maxsize) {
+        cells = new cell_t[maxsize]();
+    }
+
+    void release() {
+        delete[] cells;
+    }
+
+    T &value(long long node) { return cells[node].value; }
+
+    long long next(long long node) const { return loadIndex(cells[node].next); }
+
+    long long prev(long long node) const { return loadIndex(cells[node].prev); }
+
+    void setNext(long long node, long long link) { cells[node].next = storeIndex<Index>(link); }
+
+    void setPrev(long long node, long long link) { cells[node].prev = storeIndex<Index>(link); }
+};
+
+/**
+ * Index-based list that keeps values of type T inline in the slot storage.
+ * head, tail, emptyHead and links have the same meaning as in list_t.
+ * Layout is soaLayout<T, Index> (default) or aosLayout<T, Index>
+ */
+
+template<typename T, typename Layout = soaLayout<T>>
+struct typedList_t {
+    Layout cells;
+    long long head;
+    long long tail;
+    size_t size;
+    size_t maxsize;
+    long long emptyHead;
+};
+
+/**
+ * Function that returns reference to the value of the cell
+ * @param list Pointer to typedList_t
+ * @param node Physical number of cell
+ * @return Reference to the value
+ */
+
+template<typename T, typename Layout>
+T &listValue(typedList_t<T, Layout> *list, long long node) {
+    return list->cells.value(node);
+}
+
+/**
+ * Function that returns next link of the cell
+ * @param list Pointer to typedList_t
+ * @param node Physical number of cell
+ * @return Physical number of the next cell, -1 if there is none
+ */
+
+template<typename T, typename Layout>
+long long listNext(typedList_t<T, Layout> *list, long long node) {
+    return list->cells.next(node);
+}
+
+/**
+ * Function that returns previous link of the cell
+ * @param list Pointer to typedList_t
+ * @param node Physical number of cell
+ * @return Physical number of the previous cell, -1 if there is none
+ */
+
+template<typename T, typename Layout>
+long long listPrev(typedList_t<T, Layout> *list, long long node) {
+    return list->cells.prev(node);
+}
+
+/**
+ * Function that sets next link of the cell
+ * @param list Pointer to typedList_t
+ * @param node Physical number of cell
+ * @param link Physical number of the next cell, -1 if there is none
+ */
+
+template<typename T, typename Layout>
+void listSetNext(typedList_t<T, Layout> *list, long long node, long long link) {
+    list->cells.setNext(node, link);
+}
+
+/**
+ * Function that sets previous link of the cell
+ * @param list Pointer to typedList_t
+ * @param node Physical number of cell
+ * @param link Physical number of the previous cell, -1 if there is none
+ */
+
+template<typename T, typename Layout>
+void listSetPrev(typedList_t<T, Layout> *list, long long node, long long link) {
+    list->cells.setPrev(node, link);
+}
+
+/**
+ * Typed list "constructor"
+ * @tparam T Type of values
+ * @tparam Layout Cell layout, soaLayout<T, Index> or aosLayout<T, Index>
+ * @param maxsize Maximal size of list, at most maxCellsFor<Index>()
+ * @return Pointer to typedList_t
+ */
+
+template<typename T, typename Layout = soaLayout<T>>
+typedList_t<T, Layout> *createTypedList(size_t maxsize) {
+    assert(maxsize > 0);
+    assert(maxsize <= maxCellsFor<typename Layout::index_t>());
+
+    typedList_t<T, Layout> *list = (typedList_t<T, Layout> *) calloc(1, sizeof(typedList_t<T, Layout>));
+    list->cells.allocate(maxsize);
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+    list->maxsize = maxsize;
+    list->emptyHead = 0;
+
+    for (long long i = maxsize - 1; i >= 0; i--) {
+        listSetNext(list, i, -1);
+        listSetPrev(list, i, i + 1);
+    }
+    listSetPrev(list, maxsize - 1, -1);
+
+    return list;
+}
+
+/**
+ * Function that returns position of an empty element
+ * @param list Pointer to typedList_t
+ * @return Physical number of empty cell, -1 if list is full
+ */
+
+template<typename T, typename Layout>
+long long getEmpty(typedList_t<T, Layout> *list) {
+    assert(list);
+
+    long long empty = list->emptyHead;
+    if (empty == -1)
+        return -1;
+
+    list->emptyHead = listPrev(list, empty);
+    listSetPrev(list, empty, -1);
+    return empty;
+}
+
+/**
+ * Function that adds cell to the list of the empty cells
+ * @param list Pointer to typedList_t
+ * @param num Physical number of cell
+ */
+
+template<typename T, typename Layout>
+void addEmpty(typedList_t<T, Layout> *list, long long num) {
+    assert(list);
+
+    listSetNext(list, num, -1);
+    listSetPrev(list, num, list->emptyHead);
+    list->emptyHead = num;
+}
+
+/**
+ * Function that clears typed list
+ * @param list Pointer to typedList_t
+ */
+
+template<typename T, typename Layout>
+void clearList(typedList_t<T, Layout> *list) {
+    assert(list);
+
+    long long node = list->head;
+
+    while (node != -1) {
+        long long next = listNext(list, node);
+        listValue(list, node) = T();
+        addEmpty(list, node);
+        node = next;
+    }
+
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+}
+
+/**
+ * Typed list "destructor"
+ * @param list Pointer to pointer to typedList_t
+ */
+
+template<typename T, typename Layout>
+void deleteList(typedList_t<T, Layout> **list) {
+    assert(list);
+    assert(*list);
+
+    (*list)->cells.release();
+    free(*list);
+    *list = nullptr;
+}
+
+/**
+ * Function that inserts element after the given one
+ * @param list Pointer to typedList_t
+ * @param elem Physical number of element, -1 to insert to the head
+ * @param value Value to copy into the list
+ * @return Physical number of the new element, -1 if list is full
+ */
+
+template<typename T, typename Layout>
+long long insertAfter(typedList_t<T, Layout> *list, long long elem, const T &value) {
+    assert(list);
+
+    long long newNode = getEmpty(list);
+    if (newNode == -1)
+        return -1;
+
+    long long tmp = (elem == -1) ? list->head : listNext(list, elem);
+
+    listValue(list, newNode) = value;
+    listSetPrev(list, newNode, elem);
+    listSetNext(list, newNode, tmp);
+
+    if (elem != -1)
+        listSetNext(list, elem, newNode);
+    else
+        list->head = newNode;
+
+    if (tmp != -1)
+        listSetPrev(list, tmp, newNode);
+    else
+        list->tail = newNode;
+
+    list->size++;
+
+    return newNode;
+}
+
+/**
+ * Function that inserts element before the given one
+ * @param list Pointer to typedList_t
+ * @param elem Physical number of element
+ * @param value Value to copy into the list
+ * @return Physical number of the new element, -1 if list is full
+ */
+
+template<typename T, typename Layout>
+long long insertBefore(typedList_t<T, Layout> *list, long long elem, const T &value) {
+    assert(list);
+    assert(elem >= 0);
+
+    return insertAfter(list, listPrev(list, elem), value);
+}
+
+/**
+ * Function that adds value to the head of the list
+ * @param list Pointer to typedList_t
+ * @param value Value to copy into the list
+ * @return Physical number of the new element, -1 if list is full
+ */
+
+template<typename T, typename Layout>
+long long addToHead(typedList_t<T, Layout> *list, const T &value) {
+    return insertAfter(list, -1, value);
+}
+
+/**
+ * Function that adds value to the tail of the list
+ * @param list Pointer to typedList_t
+ * @param value Value to copy into the list
+ * @return Physical number of the new element, -1 if list is full
+ */
+
+template<typename T, typename Layout>
+long long addToTail(typedList_t<T, Layout> *list, const T &value) {
+    assert(list);
+
+    return insertAfter(list, list->tail, value);
+}
+
+/**
+ * Function that deletes node
+ * @param list Pointer to typedList_t
+ * @param node Physical number of the node
+ */
+
+template<typename T, typename Layout>
+void deleteNode(typedList_t<T, Layout> *list, long long node) {
+    assert(list);
+    assert(node >= 0);
+    assert(node < (long long) list->maxsize);
+
+    if (listPrev(list, node) != -1)
+        listSetNext(list, listPrev(list, node), listNext(list, node));
+    else
+        list->head = listNext(list, node);
+
+    if (listNext(list, node) != -1)
+        listSetPrev(list, listNext(list, node), listPrev(list, node));
+    else
+        list->tail = listPrev(list, node);
+
+    listValue(list, node) = T();
+    list->size--;
+    addEmpty(list, node);
+}
+
+/**
+ * Function that returns physical address by logical address
+ * @param list Pointer to typedList_t
+ * @param position Logical position
+ * @return Physical position, -1 if there is no such position
+ */
+
+template<typename T, typename Layout>
+long long getElementByPosition(typedList_t<T, Layout> *list, size_t position) {
+    assert(list);
+
+    if (position >= list->size)
+        return -1;
+
+    long long node = list->head;
+
+    for (size_t i = 0; i < position; i++)
+        node = listNext(list, node);
+
+    return node;
+}
+
+/**
+ * Function that finds first occurance of the value
+ * @param list Pointer to typedList_t
+ * @param value Value to find
+ * @param cmp Equality predicate, operator== by default
+ * @return Physical address of the element, -1 if not found
+ */
+
+template<typename T, typename Layout, typename Cmp>
+long long findFirstNode(typedList_t<T, Layout> *list, const T &value, Cmp cmp) {
+    assert(list);
+
+    for (long long node = list->head; node != -1; node = listNext(list, node)) {
+        if (cmp(listValue(list, node), value))
+            return node;
+    }
+
+    return -1;
+}
+
+template<typename T, typename Layout>
+long long findFirstNode(typedList_t<T, Layout> *list, const T &value) {
+    return findFirstNode(list, value, [](const T &a, const T &b) { return a == b; });
+}
+
+/**
+ * Function that finds last occurance of the value
+ * @param list Pointer to typedList_t
+ * @param value Value to find
+ * @param cmp Equality predicate, operator== by default
+ * @return Physical address of the element, -1 if not found
+ */
+
+template<typename T, typename Layout, typename Cmp>
+long long findLastNode(typedList_t<T, Layout> *list, const T &value, Cmp cmp) {
+    assert(list);
+
+    for (long long node = list->tail; node != -1; node = listPrev(list, node)) {
+        if (cmp(listValue(list, node), value))
+            return node;
+    }
+
+    return -1;
+}
+
+template<typename T, typename Layout>
+long long findLastNode(typedList_t<T, Layout> *list, const T &value) {
+    return findLastNode(list, value, [](const T &a, const T &b) { return a == b; });
+}
+
+/**
+ * Function that validates the typed list
+ * @param list Pointer to typedList_t
+ * @return List Validity value
+ */
+
+template<typename T, typename Layout>
+listValidity validateList(typedList_t<T, Layout> *list) {
+    if (!list)
+        return LIST_NOT_FOUND;
+
+    long long node = list->head;
+    long long last = -1;
+
+    for (size_t i = 0; i < list->size; i++) {
+        if (node == -1 || listPrev(list, node) != last)
+            return CORRUPTED;
+
+        last = node;
+        node = listNext(list, node);
+    }
+
+    if (node != -1 || list->tail != last)
+        return CORRUPTED;
+
+    return OK;
+}
+
+/**
+ * Function that swaps contents of two occupied cells and fixes links pointing to them
+ * @param list Pointer to typedList_t
+ * @param a Physical number of the first cell
+ * @param b Physical number of the second cell
+ */
+
+template<typename T, typename Layout>
+void swapCells(typedList_t<T, Layout> *list, long long a, long long b) {
+    std::swap(listValue(list, a), listValue(list, b));
+
+    long long swapped[2] = {a, b};
+    long long next[2] = {listNext(list, b), listNext(list, a)};
+    long long prev[2] = {listPrev(list, b), listPrev(list, a)};
+
+    for (int i = 0; i < 2; i++) {
+        long long *links[2] = {&next[i], &prev[i]};
+
+        for (long long *link : links) {
+            if (*link == a)
+                *link = b;
+            else if (*link == b)
+                *link = a;
+        }
+
+        listSetNext(list, swapped[i], next[i]);
+        listSetPrev(list, swapped[i], prev[i]);
+    }
+
+    for (long long cell : swapped) {
+        if (listPrev(list, cell) != -1)
+            listSetNext(list, listPrev(list, cell), cell);
+        else
+            list->head = cell;
+
+        if (listNext(list, cell) != -1)
+            listSetPrev(list, listNext(list, cell), cell);
+        else
+            list->tail = cell;
+    }
+}
+
+/**
+ * Function that places elements in cells in their logical order without extra memory
+ * @param list Pointer to typedList_t
+ */
+
+template<typename T, typename Layout>
+void sortList(typedList_t<T, Layout> *list) {
+    assert(list);
+
+    const long long FREE_CELL = list->maxsize;
+
+    for (long long empty = list->emptyHead; empty != -1; empty = listPrev(list, empty))
+        listSetNext(list, empty, FREE_CELL);
+
+    long long node = list->head;
+
+    for (long long pos = 0; pos < (long long) list->size; pos++) {
+        if (node != pos) {
+            if (listNext(list, pos) == FREE_CELL) {
+                listValue(list, pos) = std::move(listValue(list, node));
+                listSetNext(list, pos, listNext(list, node));
+                listSetPrev(list, pos, listPrev(list, node));
+                listSetNext(list, node, FREE_CELL);
+
+                if (listPrev(list, pos) != -1)
+                    listSetNext(list, listPrev(list, pos), pos);
+                else
+                    list->head = pos;
+
+                if (listNext(list, pos) != -1)
+                    listSetPrev(list, listNext(list, pos), pos);
+                else
+                    list->tail = pos;
+            } else {
+                swapCells(list, node, pos);
+            }
+        }
+
+        node = listNext(list, pos);
+    }
+
+    list->emptyHead = -1;
+
+    for (long long i = list->maxsize - 1; i >= (long long) list->size; i--)
+        addEmpty(list, i);
+}
+
+#endif //DOUBLYLINKEDLISTDED_TYPEDLIST_H
@@ -1,6 +1,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 #define ANSI_COLOR_RED "\x1b[31m"
 #define ANSI_COLOR_GREEN "\x1b[32m"
@@ -35,6 +37,19 @@ struct list_t {
     size_t size;
 };
 
+/**
+ * Snapshot has the same format as snapshots of DoublyLinkedListDed: LIST_SNAPSHOT_MAGIC, version
+ * and flags bytes, maxsize (always 0 here) and size as varints, then values in logical order
+ */
+
+const unsigned char LIST_SNAPSHOT_MAGIC[4] = {'L', 'S', 'N', 'P'};
+
+const unsigned char LIST_SNAPSHOT_VERSION = 1;
+
+const unsigned char SNAPSHOT_HANDLES = 1; // Values are handles stored as zigzag varint deltas
+
+const size_t SNAPSHOT_BUFFER_SIZE = 1 << 16;
+
 list_t *createList();
 
 node_t *getElementByPosition(list_t *list, size_t position);
@@ -67,6 +82,23 @@ void deleteNode(list_t *list, node_t *elem);
 
 void clearList(list_t *list);
 
+void spliceRange(list_t *dst, node_t *after, list_t *src, node_t *first, node_t *last, size_t count);
+
+void concatLists(list_t *dst, list_t *src);
+
+list_t *splitList(list_t *list, node_t *node);
+
+void sortListBy(list_t *list, int (*cmp)(void *, void *));
+
+void writeVarint(FILE *file, unsigned long long number);
+
+bool readVarint(FILE *file, unsigned long long *number);
+
+int saveList(list_t *list, const char *path, const void *(*serialize)(void *, size_t *, void *) = nullptr,
+             void *arg = nullptr);
+
+list_t *loadList(const char *path, void *(*deserialize)(const void *, size_t, void *) = nullptr, void *arg = nullptr);
+
 void dumpList(list_t *list, const char *dumpFilename,  char *(*nodeDump)(node_t *) = nullptr);
 
 char *nodeDump(node_t *node) { // Example function
@@ -74,6 +106,19 @@ char *nodeDump(node_t *node) { // Example function
     sprintf(str, "{VALUE|%d}|{NEXT|%p}|{PREVIOUS|%p}", *(int *)(node->value), node->next, node->prev);
     return (char *)str;
 }
+int compareInts(void *first, void *second) { // Example function
+    return *(int *) first - *(int *) second;
+}
+const void *serializeInt(void *value, size_t *size, void *) { // Example function
+    *size = sizeof(int);
+    return value;
+}
+void *deserializeInt(const void *bytes, size_t size, void *arg) { // Example function, arg points to the next free int
+    int *place = (*(int **) arg)++;
+    memcpy(place, bytes, size);
+    return place;
+}
+
 /**
  * Function that performs unit testing
  * @return Validity of the library
@@ -123,8 +168,85 @@ bool doUnitTesting() {
 
     UTEST(validateList(testList) == OK, valid);
     dumpList(testList, "unitTestingDump.dot", nodeDump);
+
+    list_t *second = splitList(testList, getElementByPosition(testList, 5));
+    UTEST(testList->size == 5, valid);
+    UTEST(second->size == 3, valid);
+    UTEST(second->head->value == &vals[6], valid);
+    UTEST(testList->tail->value == &vals[5], valid);
+    UTEST(!testList->tail->next && !second->head->prev, valid);
+
+    spliceRange(second, nullptr, testList, getElementByPosition(testList, 1), getElementByPosition(testList, 2), 2);
+    UTEST(testList->size == 3, valid);
+    UTEST(second->size == 5, valid);
+    UTEST(second->head->value == &vals[2], valid);
+    UTEST(getElementByPosition(testList, 1)->value == &vals[4], valid);
+    UTEST(getElementByPosition(second, 2)->value == &vals[6], valid);
+
+    concatLists(testList, second);
+    UTEST(testList->size == 8, valid);
+    UTEST(second->size == 0 && !second->head && !second->tail, valid);
+    UTEST(getElementByPosition(testList, 3)->value == &vals[2], valid);
+    UTEST(getElementByPosition(testList, 3)->prev->value == &vals[5], valid);
+    UTEST(validateList(testList) == OK, valid);
+
+    deleteList(&second);
     deleteList(&testList);
     UTEST(!testList, valid);
+
+    int keys[8] = {4, 1, 4, 0, 9, 1, 7, 4};
+    list_t *sortedList = createList();
+
+    for(int i = 0; i < 8; i++)
+        addToTail(sortedList, &keys[i]);
+
+    sortListBy(sortedList, compareInts);
+    int *expected[8] = {&keys[3], &keys[1], &keys[5], &keys[0], &keys[2], &keys[7], &keys[6], &keys[4]};
+    node_t *node = sortedList->head;
+
+    for(int i = 0; i < 8; i++) {
+        UTEST(node->value == expected[i], valid);
+        UTEST(i == 0 || node->prev->next == node, valid);
+        node = node->next;
+    }
+
+    UTEST(sortedList->tail->value == &keys[4], valid);
+    UTEST(validateList(sortedList) == OK, valid);
+
+    UTEST(saveList(sortedList, "unitTestingSnapshot.bin", serializeInt), valid);
+    UTEST(!loadList("unitTestingSnapshot.bin"), valid);
+
+    int restored[8] = {};
+    int *next = restored;
+    list_t *loadedList = loadList("unitTestingSnapshot.bin", deserializeInt, &next);
+    UTEST(loadedList && loadedList->size == 8 && next == restored + 8, valid);
+
+    node = sortedList->head;
+    for(node_t *copy = loadedList ? loadedList->head : nullptr; copy; copy = copy->next, node = node->next)
+        UTEST(*(int *) copy->value == *(int *) node->value, valid);
+    UTEST(loadedList && validateList(loadedList) == OK, valid);
+
+    if(loadedList)
+        deleteList(&loadedList);
+    deleteList(&sortedList);
+
+    list_t *handleList = createList();
+    for(long long i = 0; i < 1000; i++)
+        addToTail(handleList, (void *) ((i % 2 ? -i : i) * (1ll << 33)));
+
+    UTEST(saveList(handleList, "unitTestingSnapshot.bin"), valid);
+    loadedList = loadList("unitTestingSnapshot.bin");
+    UTEST(loadedList && loadedList->size == 1000, valid);
+
+    node = handleList->head;
+    for(node_t *copy = loadedList ? loadedList->head : nullptr; copy; copy = copy->next, node = node->next)
+        UTEST(copy->value == node->value, valid);
+
+    if(loadedList)
+        deleteList(&loadedList);
+    deleteList(&handleList);
+    UTEST(!loadList("unitTestingDump.dot"), valid);
+    remove("unitTestingSnapshot.bin");
     return valid;
 }
 
@@ -160,12 +282,14 @@ void clearList(list_t *list) {
     node_t *curNode = list->head;
     node_t *next = nullptr;
 
-    while(curNode != list->tail) {
+    while(curNode) {
         next = curNode->next;
         free(curNode);
         curNode = next;
     }
 
+    list->head = nullptr;
+    list->tail = nullptr;
     list->size = 0;
 }
 
@@ -509,4 +633,344 @@ void dumpList(list_t *list, const char *dumpFilename, char *(*nodeDump)(node_t *
     fprintf(dumpFile, "node%p -> Tail;\n", list->tail);
     fprintf(dumpFile, "}");
     fclose(dumpFile);
-}
\ No newline at end of file
+}
+
+/**
+ * Function that moves nodes from first to last from src list after the given node of dst list in O(1)
+ * @param dst Pointer to destination list_t
+ * @param after Pointer to node_t of dst, nullptr to move to the head
+ * @param src Pointer to source list_t
+ * @param first Pointer to the first moved node_t
+ * @param last Pointer to the last moved node_t
+ * @param count Number of nodes from first to last
+ */
+
+void spliceRange(list_t *dst, node_t *after, list_t *src, node_t *first, node_t *last, size_t count) {
+    assert(dst);
+    assert(src);
+    assert(first);
+    assert(last);
+
+    if(first->prev)
+        first->prev->next = last->next;
+    else
+        src->head = last->next;
+
+    if(last->next)
+        last->next->prev = first->prev;
+    else
+        src->tail = first->prev;
+
+    src->size -= count;
+
+    node_t *afterNext = after ? after->next : dst->head;
+
+    first->prev = after;
+    if(after)
+        after->next = first;
+    else
+        dst->head = first;
+
+    last->next = afterNext;
+    if(afterNext)
+        afterNext->prev = last;
+    else
+        dst->tail = last;
+
+    dst->size += count;
+}
+
+/**
+ * Function that moves all nodes of src list to the tail of dst list in O(1)
+ * @param dst Pointer to destination list_t
+ * @param src Pointer to source list_t
+ */
+
+void concatLists(list_t *dst, list_t *src) {
+    assert(dst);
+    assert(src);
+    assert(dst != src);
+
+    if(!src->head)
+        return;
+
+    spliceRange(dst, dst->tail, src, src->head, src->tail, src->size);
+}
+
+/**
+ * Function that splits list before the given node. Size of the new list is counted
+ * from both ends at once, i. e. in O(min(k, n - k))
+ * @param list Pointer to list_t
+ * @param node Pointer to the first node_t of the new list
+ * @return Pointer to new list_t with nodes from node to tail
+ */
+
+list_t *splitList(list_t *list, node_t *node) {
+    assert(list);
+    assert(node);
+
+    list_t *newList = createList();
+    node_t *forward = node;
+    node_t *backward = node->prev;
+    size_t steps = 0;
+    size_t count = 0;
+
+    while(true) {
+        if(!forward) {
+            count = steps;
+            break;
+        }
+
+        if(!backward) {
+            count = list->size - steps;
+            break;
+        }
+
+        forward = forward->next;
+        backward = backward->prev;
+        steps++;
+    }
+
+    spliceRange(newList, nullptr, list, node, list->tail, count);
+
+    return newList;
+}
+
+/**
+ * Function that sorts list by values with stable bottom-up merge sort.
+ * Only links are changed, no extra memory is used
+ * @param list Pointer to list_t
+ * @param cmp Comparator that returns negative, zero or positive number like for qsort
+ */
+
+void sortListBy(list_t *list, int (*cmp)(void *, void *)) {
+    assert(list);
+    assert(cmp);
+
+    if(list->size < 2)
+        return;
+
+    node_t *head = list->head;
+
+    for(size_t width = 1;; width *= 2) {
+        node_t *left = head;
+        node_t *tail = nullptr;
+        size_t merges = 0;
+
+        head = nullptr;
+
+        while(left) {
+            node_t *right = left;
+            size_t leftSize = 0;
+            size_t rightSize = width;
+
+            merges++;
+
+            while(leftSize < width && right) {
+                leftSize++;
+                right = right->next;
+            }
+
+            while(leftSize > 0 || (rightSize > 0 && right)) {
+                node_t *node = nullptr;
+
+                if(leftSize > 0 && (rightSize == 0 || !right || cmp(left->value, right->value) <= 0)) {
+                    node = left;
+                    left = left->next;
+                    leftSize--;
+                }
+                else {
+                    node = right;
+                    right = right->next;
+                    rightSize--;
+                }
+
+                if(tail)
+                    tail->next = node;
+                else
+                    head = node;
+                tail = node;
+            }
+
+            left = right;
+        }
+
+        tail->next = nullptr;
+
+        if(merges <= 1)
+            break;
+    }
+
+    node_t *prev = nullptr;
+
+    for(node_t *node = head; node; node = node->next) {
+        node->prev = prev;
+        prev = node;
+    }
+
+    list->head = head;
+    list->tail = prev;
+}
+
+/**
+ * Function that writes number in LEB128 varint encoding, 7 bits per byte starting from the lowest
+ * @param file Pointer to FILE
+ * @param number Number
+ */
+
+void writeVarint(FILE *file, unsigned long long number) {
+    while(number >= 0x80) {
+        putc((int) ((number & 0x7f) | 0x80), file);
+        number >>= 7;
+    }
+    putc((int) number, file);
+}
+
+/**
+ * Function that reads number in LEB128 varint encoding
+ * @param file Pointer to FILE
+ * @param number Place for the number
+ * @return False if the file ends earlier or the number is longer than 64 bits, True otherwise
+ */
+
+bool readVarint(FILE *file, unsigned long long *number) {
+    *number = 0;
+
+    for(unsigned shift = 0; shift < 64; shift += 7) {
+        int byte = getc(file);
+        if(byte == EOF)
+            return false;
+
+        *number |= (unsigned long long) (byte & 0x7f) << shift;
+        if(!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Function that saves list to a binary snapshot in logical order. Without serializer values are
+ * handles, i. e. integers cast to void *, and are stored as zigzag varint deltas of consecutive
+ * values. With serializer each value is stored as varint length and the bytes it returns
+ * @param list Pointer to list_t
+ * @param path Path to the snapshot
+ * @param serialize Function that gets value and arg, returns pointer to the bytes of value and
+ * puts their number to size, the bytes must stay valid until the next call. nullptr for handles
+ * @param arg Argument for serialize
+ * @return 0 if error occures, 1 otherwise
+ */
+
+int saveList(list_t *list, const char *path, const void *(*serialize)(void *, size_t *, void *), void *arg) {
+    assert(list);
+    assert(path);
+
+    FILE *file = fopen(path, "wb");
+    if(!file)
+        return 0;
+
+    setvbuf(file, nullptr, _IOFBF, SNAPSHOT_BUFFER_SIZE);
+
+    unsigned char flags = serialize ? 0 : SNAPSHOT_HANDLES;
+
+    fwrite(LIST_SNAPSHOT_MAGIC, 1, sizeof(LIST_SNAPSHOT_MAGIC), file);
+    putc(LIST_SNAPSHOT_VERSION, file);
+    putc(flags, file);
+    writeVarint(file, 0);
+    writeVarint(file, list->size);
+
+    unsigned long long previous = 0;
+
+    for(node_t *node = list->head; node; node = node->next) {
+        if(serialize) {
+            size_t size = 0;
+            const void *bytes = serialize(node->value, &size, arg);
+
+            writeVarint(file, size);
+            fwrite(bytes, 1, size, file);
+        }
+        else {
+            unsigned long long delta = (unsigned long long) (uintptr_t) node->value - previous;
+
+            writeVarint(file, (delta << 1) ^ (unsigned long long) ((long long) delta >> 63));
+            previous = (uintptr_t) node->value;
+        }
+    }
+
+    int saved = !ferror(file);
+    saved = (fclose(file) == 0) && saved;
+
+    return saved;
+}
+
+/**
+ * Function that loads list from a snapshot written by saveList of either implementation
+ * in one sequential pass over the file. maxsize of the snapshot is ignored
+ * @param path Path to the snapshot
+ * @param deserialize Function that gets bytes of value, their number and arg and returns value.
+ * nullptr if the snapshot stores handles
+ * @param arg Argument for deserialize
+ * @return Pointer to list_t, nullptr if the file cannot be read or is not a snapshot of this kind
+ */
+
+list_t *loadList(const char *path, void *(*deserialize)(const void *, size_t, void *), void *arg) {
+    assert(path);
+
+    FILE *file = fopen(path, "rb");
+    if(!file)
+        return nullptr;
+
+    setvbuf(file, nullptr, _IOFBF, SNAPSHOT_BUFFER_SIZE);
+
+    unsigned char header[sizeof(LIST_SNAPSHOT_MAGIC) + 2] = {};
+    unsigned long long maxsize = 0;
+    unsigned long long size = 0;
+    bool loaded = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+                  memcmp(header, LIST_SNAPSHOT_MAGIC, sizeof(LIST_SNAPSHOT_MAGIC)) == 0 &&
+                  header[sizeof(LIST_SNAPSHOT_MAGIC)] == LIST_SNAPSHOT_VERSION;
+
+    if(loaded) {
+        bool handles = header[sizeof(LIST_SNAPSHOT_MAGIC) + 1] & SNAPSHOT_HANDLES;
+        loaded = (handles == !deserialize) && readVarint(file, &maxsize) && readVarint(file, &size);
+    }
+
+    list_t *list = loaded ? createList() : nullptr;
+    unsigned char *bytes = nullptr;
+    size_t bytesSize = 0;
+    unsigned long long previous = 0;
+
+    for(unsigned long long i = 0; loaded && i < size; i++) {
+        unsigned long long number = 0;
+        loaded = readVarint(file, &number);
+
+        if(!loaded)
+            break;
+
+        if(deserialize) {
+            if(bytesSize < number) {
+                unsigned char *newBytes = (unsigned char *) realloc(bytes, number);
+                loaded = newBytes != nullptr;
+                if(!loaded)
+                    break;
+                bytes = newBytes;
+                bytesSize = number;
+            }
+
+            loaded = fread(bytes, 1, number, file) == number;
+            if(loaded)
+                addToTail(list, deserialize(bytes, number, arg));
+        }
+        else {
+            previous += (number >> 1) ^ (~(number & 1) + 1);
+            addToTail(list, (void *) (uintptr_t) previous);
+        }
+    }
+
+    if(!loaded && list)
+        deleteList(&list);
+
+    fclose(file);
+    free(bytes);
+
+    return list;
+}